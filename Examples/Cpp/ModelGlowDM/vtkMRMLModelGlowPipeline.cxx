@@ -20,7 +20,12 @@
 
 vtkStandardNewMacro(vtkMRMLModelGlowPipeline);
 
-vtkMRMLModelGlowPipeline::vtkMRMLModelGlowPipeline() = default;
+vtkMRMLModelGlowPipeline::vtkMRMLModelGlowPipeline()
+{
+  // The bounds check only reads the bounds cached in UpdatePipeline and can be polled on the interaction worker threads
+  this->SetReentrantCanProcessInteractionEvent(true);
+}
+
 vtkMRMLModelGlowPipeline::~vtkMRMLModelGlowPipeline() = default;
 
 void vtkMRMLModelGlowPipeline::SetDisplayNode(vtkMRMLNode* displayNode)
@@ -61,6 +66,17 @@ void vtkMRMLModelGlowPipeline::UpdatePipeline()
     this->GlowActor->GetProperty()->SetColor(color);
   }
 
+  // Actor bounds are lazily computed from the mapper input, cache them for CanProcessInteractionEvent
+  this->HasBounds = this->GetDisplayNode() && this->ModelNode;
+  if (this->HasBounds)
+  {
+    this->GlowActor->GetBounds(this->Bounds);
+    for (int i = 0; i < 3; i++)
+    {
+      this->Center[i] = 0.5 * (this->Bounds[2 * i] + this->Bounds[2 * i + 1]);
+    }
+  }
+
   RequestRender();
 }
 
@@ -106,16 +122,16 @@ void vtkMRMLModelGlowPipeline::OnUpdate(vtkObject* node, unsigned long eventId,
 
 bool vtkMRMLModelGlowPipeline::CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2)
 {
-  if (!this->GetDisplayNode() || !this->ModelNode)
+  if (!this->HasBounds)
   {
     return false;
   }
 
   const double* wp = eventData->GetWorldPosition();
-  double* bnds = this->GlowActor->GetBounds();
+  const double* bnds = this->Bounds;
 
   bool inBounds = (wp[0] > bnds[0] && wp[0] < bnds[1] && wp[1] > bnds[2] && wp[1] < bnds[3] && wp[2] > bnds[4] && wp[2] < bnds[5]);
-  distance2 = vtkMath::Distance2BetweenPoints(wp, this->GlowActor->GetCenter());
+  distance2 = vtkMath::Distance2BetweenPoints(wp, this->Center);
 
   return inBounds;
 }
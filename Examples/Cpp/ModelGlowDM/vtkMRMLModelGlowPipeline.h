@@ -48,4 +48,7 @@ private:
 
   vtkWeakPointer<vtkMRMLModelNode> ModelNode{ nullptr };
   vtkNew<vtkActor> GlowActor;
+  bool HasBounds{ false };
+  double Bounds[6]{};
+  double Center[3]{};
 };
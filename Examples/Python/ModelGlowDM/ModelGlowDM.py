@@ -133,6 +133,7 @@ class GlowDMPassPipeline(_Pipeline):
     Since the pass only need to be set once, the following are used in this class:
         - The data node is set to be a singleton data. This will make the data node persist in between scene clear.
         - Setting and removing the render pass is done on renderer added / removed API calls.
+        - The pipeline declares its custom render pass so that its layer is never merged with other layers.
         - We set the pipeline to its own renderer (GetRenderOrder != 0) and we make it easy for other classes to know
             the pipeline's render order by adding a convenience static method.
 
@@ -148,6 +149,7 @@ class GlowDMPassPipeline(_Pipeline):
         self._basicPasses = vtkRenderStepsPass()
         self._glowPass = vtkOutlineGlowPass()
         self._glowPass.SetDelegatePass(self._basicPasses)
+        self.SetUsesCustomRenderPass(True)
 
     def OnRendererAdded(self, renderer: vtkRenderer) -> None:
         """
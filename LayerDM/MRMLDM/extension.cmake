@@ -21,10 +21,16 @@ SlicerConfigureDisplayableManagerObjectFactory(
 set(${KIT}_SRCS
   ${displayable_manager_instantiator_SRCS}
   ${displayable_manager_SRCS}
+  vtkMRMLLayerDMBoundingVolumeHierarchy.h
+  vtkMRMLLayerDMCachedRenderPass.cxx
+  vtkMRMLLayerDMCachedRenderPass.h
   vtkMRMLLayerDMCameraSynchronizer.cxx
   vtkMRMLLayerDMCameraSynchronizer.h
+  vtkMRMLLayerDMInteractionLatency.cxx
+  vtkMRMLLayerDMInteractionLatency.h
   vtkMRMLLayerDMInteractionLogic.cxx
   vtkMRMLLayerDMInteractionLogic.h
+  vtkMRMLLayerDMLatencyHistogram.h
   vtkMRMLLayerDMLayerManager.cxx
   vtkMRMLLayerDMLayerManager.h
   vtkMRMLLayerDMPipelineCallbackCreator.cxx
@@ -38,6 +44,10 @@ set(${KIT}_SRCS
   vtkMRMLLayerDMPipelineI.h
   vtkMRMLLayerDMPipelineManager.cxx
   vtkMRMLLayerDMPipelineManager.h
+  vtkMRMLLayerDMPipelineRegistry.h
+  vtkMRMLLayerDMThreadPool.h
+  vtkMRMLLayerDMTracer.cxx
+  vtkMRMLLayerDMTracer.h
   vtkMRMLLayerDisplayableManager.h
 )
 
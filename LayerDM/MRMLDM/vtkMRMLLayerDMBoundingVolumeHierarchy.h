@@ -0,0 +1,229 @@
+#pragma once
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace layer_dm
+{
+/// \brief Axis aligned bounding box hierarchy used to select the interaction candidates of
+/// \sa vtkMRMLLayerDMInteractionLogic.
+///
+/// Boxes are stored in the VTK bounds order (xmin, xmax, ymin, ymax, ...) and identified by their index at build time.
+/// The tree is built top-down by splitting the items at the median of the largest box centers extent. Each leaf holds
+/// a single item. Moving an item's box only refits the boxes of its ancestors, the tree topology is kept until the next
+/// build.
+template <int Dimension>
+class BoundingVolumeHierarchy
+{
+public:
+  using Box = std::array<double, 2 * Dimension>;
+
+  /// Rebuild the hierarchy for the input boxes. Items are identified by their index in the input vector.
+  void Build(const std::vector<Box>& boxes)
+  {
+    this->m_nodes.clear();
+    this->m_itemLeaves.assign(boxes.size(), -1);
+    if (boxes.empty())
+    {
+      return;
+    }
+
+    this->m_nodes.reserve(2 * boxes.size() - 1);
+    std::vector<int> items(boxes.size());
+    for (std::size_t iItem = 0; iItem < items.size(); ++iItem)
+    {
+      items[iItem] = static_cast<int>(iItem);
+    }
+    this->BuildNode(boxes, items, 0, static_cast<int>(items.size()), -1);
+  }
+
+  /// Update the box of the input item and of its ancestors.
+  void Refit(int item, const Box& box)
+  {
+    if (item < 0 || item >= static_cast<int>(this->m_itemLeaves.size()))
+    {
+      return;
+    }
+
+    int iNode = this->m_itemLeaves[item];
+    this->m_nodes[iNode].Bounds = box;
+    for (iNode = this->m_nodes[iNode].Parent; iNode >= 0; iNode = this->m_nodes[iNode].Parent)
+    {
+      auto& node = this->m_nodes[iNode];
+      node.Bounds = Union(this->m_nodes[node.Left].Bounds, this->m_nodes[node.Right].Bounds);
+    }
+  }
+
+  /// Call \param callback with the index of each item whose box contains the input point.
+  /// The traversal stack is kept between queries to avoid allocations.
+  template <typename Callback>
+  void Query(const double point[Dimension], Callback&& callback) const
+  {
+    this->Traverse([point](const Box& box) { return Contains(box, point); }, std::forward<Callback>(callback));
+  }
+
+  /// Call \param callback with the index of each item whose box intersects the [start, end] segment.
+  template <typename Callback>
+  void QuerySegment(const double start[Dimension], const double end[Dimension], Callback&& callback) const
+  {
+    this->Traverse([start, end](const Box& box) { return IntersectsSegment(box, start, end); }, std::forward<Callback>(callback));
+  }
+
+  int GetNumberOfItems() const { return static_cast<int>(this->m_itemLeaves.size()); }
+
+private:
+  struct Node
+  {
+    Box Bounds{};
+    int Parent{ -1 };
+    int Left{ -1 };
+    int Right{ -1 };
+    int Item{ -1 };
+  };
+
+  /// Depth first traversal of the nodes whose box overlaps the query
+  template <typename Overlaps, typename Callback>
+  void Traverse(Overlaps&& overlaps, Callback&& callback) const
+  {
+    if (this->m_nodes.empty())
+    {
+      return;
+    }
+
+    this->m_stack.clear();
+    this->m_stack.push_back(0);
+    while (!this->m_stack.empty())
+    {
+      const auto& node = this->m_nodes[this->m_stack.back()];
+      this->m_stack.pop_back();
+      if (!overlaps(node.Bounds))
+      {
+        continue;
+      }
+
+      if (node.Item >= 0)
+      {
+        callback(node.Item);
+        continue;
+      }
+      this->m_stack.push_back(node.Left);
+      this->m_stack.push_back(node.Right);
+    }
+  }
+
+  static bool Contains(const Box& box, const double point[Dimension])
+  {
+    for (int iDim = 0; iDim < Dimension; ++iDim)
+    {
+      if (point[iDim] < box[2 * iDim] || point[iDim] > box[2 * iDim + 1])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Slab test of the segment parametrized by t in [0, 1]
+  static bool IntersectsSegment(const Box& box, const double start[Dimension], const double end[Dimension])
+  {
+    double tMin = 0;
+    double tMax = 1;
+    for (int iDim = 0; iDim < Dimension; ++iDim)
+    {
+      const double direction = end[iDim] - start[iDim];
+      if (direction == 0)
+      {
+        if (start[iDim] < box[2 * iDim] || start[iDim] > box[2 * iDim + 1])
+        {
+          return false;
+        }
+        continue;
+      }
+
+      double t0 = (box[2 * iDim] - start[iDim]) / direction;
+      double t1 = (box[2 * iDim + 1] - start[iDim]) / direction;
+      if (t0 > t1)
+      {
+        std::swap(t0, t1);
+      }
+      tMin = std::max(tMin, t0);
+      tMax = std::min(tMax, t1);
+      if (tMin > tMax)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static Box Union(const Box& a, const Box& b)
+  {
+    Box box;
+    for (int iDim = 0; iDim < Dimension; ++iDim)
+    {
+      box[2 * iDim] = std::min(a[2 * iDim], b[2 * iDim]);
+      box[2 * iDim + 1] = std::max(a[2 * iDim + 1], b[2 * iDim + 1]);
+    }
+    return box;
+  }
+
+  static double Center(const Box& box, int iDim) { return 0.5 * (box[2 * iDim] + box[2 * iDim + 1]); }
+
+  int BuildNode(const std::vector<Box>& boxes, std::vector<int>& items, int begin, int end, int parent)
+  {
+    const int iNode = static_cast<int>(this->m_nodes.size());
+    this->m_nodes.emplace_back();
+    this->m_nodes[iNode].Parent = parent;
+
+    if (end - begin == 1)
+    {
+      this->m_nodes[iNode].Bounds = boxes[items[begin]];
+      this->m_nodes[iNode].Item = items[begin];
+      this->m_itemLeaves[items[begin]] = iNode;
+      return iNode;
+    }
+
+    // Split along the axis with the largest extent of the box centers
+    int splitDim = 0;
+    double maxExtent = -1;
+    for (int iDim = 0; iDim < Dimension; ++iDim)
+    {
+      double minCenter = std::numeric_limits<double>::max();
+      double maxCenter = std::numeric_limits<double>::lowest();
+      for (int iItem = begin; iItem < end; ++iItem)
+      {
+        minCenter = std::min(minCenter, Center(boxes[items[iItem]], iDim));
+        maxCenter = std::max(maxCenter, Center(boxes[items[iItem]], iDim));
+      }
+      if (maxCenter - minCenter > maxExtent)
+      {
+        maxExtent = maxCenter - minCenter;
+        splitDim = iDim;
+      }
+    }
+
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(items.begin() + begin,
+                     items.begin() + middle,
+                     items.begin() + end,
+                     [&boxes, splitDim](int a, int b) { return Center(boxes[a], splitDim) < Center(boxes[b], splitDim); });
+
+    const int left = this->BuildNode(boxes, items, begin, middle, iNode);
+    const int right = this->BuildNode(boxes, items, middle, end, iNode);
+    auto& node = this->m_nodes[iNode];
+    node.Left = left;
+    node.Right = right;
+    node.Bounds = Union(this->m_nodes[left].Bounds, this->m_nodes[right].Bounds);
+    return iNode;
+  }
+
+  std::vector<Node> m_nodes;
+  std::vector<int> m_itemLeaves;
+  mutable std::vector<int> m_stack;
+};
+} // namespace layer_dm
@@ -0,0 +1,185 @@
+#include "vtkMRMLLayerDMCachedRenderPass.h"
+
+// Layer DM includes
+#include "vtkMRMLLayerDMLayerManager.h"
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLState.h>
+#include <vtkRenderState.h>
+#include <vtkRenderStepsPass.h>
+#include <vtkRenderer.h>
+#include <vtkTextureObject.h>
+#include <vtk_glew.h>
+
+vtkStandardNewMacro(vtkMRMLLayerDMCachedRenderPass);
+
+vtkMRMLLayerDMCachedRenderPass::vtkMRMLLayerDMCachedRenderPass()
+  : m_delegatePass(vtkSmartPointer<vtkRenderStepsPass>::New())
+{
+}
+
+vtkMRMLLayerDMCachedRenderPass::~vtkMRMLLayerDMCachedRenderPass() = default;
+
+void vtkMRMLLayerDMCachedRenderPass::Render(const vtkRenderState* state)
+{
+  this->NumberOfRenderedProps = 0;
+  auto renderer = state->GetRenderer();
+
+  // Hardware selection renders the prop ids in the selection buffers, the cached colors must not be composited
+  if (renderer->GetSelector())
+  {
+    this->m_delegatePass->Render(state);
+    this->NumberOfRenderedProps = this->m_delegatePass->GetNumberOfRenderedProps();
+    return;
+  }
+
+  auto renderWindow = vtkOpenGLRenderWindow::SafeDownCast(renderer->GetRenderWindow());
+  if (!renderWindow)
+  {
+    vtkErrorMacro("vtkMRMLLayerDMCachedRenderPass::Render failed: an OpenGL render window is required");
+    return;
+  }
+
+  int width, height, x, y;
+  renderer->GetTiledSizeAndOrigin(&width, &height, &x, &y);
+  if (width <= 0 || height <= 0)
+  {
+    return;
+  }
+
+  const auto signature = ComputeSignature(renderer, width, height);
+  if (this->m_isCacheValid && signature == this->m_signature)
+  {
+    this->m_nCacheHits++;
+  }
+  else
+  {
+    this->RenderToFramebuffer(state, renderWindow, width, height);
+    this->m_nCacheMisses++;
+
+    // Rendering may modify the renderer (for instance the automatic light creation), compute the signature afterwards
+    this->m_signature = ComputeSignature(renderer, width, height);
+    this->m_isCacheValid = true;
+  }
+
+  this->CompositeFramebuffer(renderWindow, x, y, width, height);
+}
+
+void vtkMRMLLayerDMCachedRenderPass::ReleaseGraphicsResources(vtkWindow* window)
+{
+  this->m_delegatePass->ReleaseGraphicsResources(window);
+  if (this->m_framebuffer)
+  {
+    this->m_framebuffer->ReleaseGraphicsResources(window);
+    this->m_framebuffer = nullptr;
+  }
+  this->InvalidateCache();
+}
+
+void vtkMRMLLayerDMCachedRenderPass::InvalidateCache()
+{
+  this->m_isCacheValid = false;
+}
+
+int vtkMRMLLayerDMCachedRenderPass::GetNumberOfCacheHits() const
+{
+  return this->m_nCacheHits;
+}
+
+int vtkMRMLLayerDMCachedRenderPass::GetNumberOfCacheMisses() const
+{
+  return this->m_nCacheMisses;
+}
+
+void vtkMRMLLayerDMCachedRenderPass::ResetCacheStatistics()
+{
+  this->m_nCacheHits = 0;
+  this->m_nCacheMisses = 0;
+}
+
+bool vtkMRMLLayerDMCachedRenderPass::Signature::operator==(const Signature& other) const
+{
+  return this->PropsMTime == other.PropsMTime && this->RendererMTime == other.RendererMTime && this->CameraMTime == other.CameraMTime &&
+         this->Width == other.Width && this->Height == other.Height;
+}
+
+vtkMRMLLayerDMCachedRenderPass::Signature vtkMRMLLayerDMCachedRenderPass::ComputeSignature(vtkRenderer* renderer, int width, int height)
+{
+  Signature signature;
+  signature.PropsMTime = vtkMRMLLayerDMLayerManager::GetVisiblePropsMTime(renderer);
+  signature.RendererMTime = renderer->GetMTime();
+  signature.CameraMTime = renderer->GetActiveCamera() ? renderer->GetActiveCamera()->GetMTime() : 0;
+  signature.Width = width;
+  signature.Height = height;
+  return signature;
+}
+
+void vtkMRMLLayerDMCachedRenderPass::RenderToFramebuffer(const vtkRenderState* state, vtkOpenGLRenderWindow* renderWindow, int width, int height)
+{
+  auto glState = renderWindow->GetState();
+  if (!this->m_framebuffer || this->m_framebuffer->GetContext() != renderWindow)
+  {
+    this->m_framebuffer = vtkSmartPointer<vtkOpenGLFramebufferObject>::New();
+    this->m_framebuffer->SetContext(renderWindow);
+  }
+
+  // Render the props in the offscreen framebuffer cleared to transparent black
+  glState->PushFramebufferBindings();
+  if (!this->m_framebuffer->GetColorAttachmentAsTextureObject(0))
+  {
+    this->m_framebuffer->PopulateFramebuffer(width, height, true, 1, VTK_UNSIGNED_CHAR, true, 24, 0);
+  }
+  else
+  {
+    this->m_framebuffer->Resize(width, height);
+  }
+  this->m_framebuffer->Bind();
+  this->m_framebuffer->StartNonOrtho(width, height);
+
+  glState->vtkglViewport(0, 0, width, height);
+  glState->vtkglScissor(0, 0, width, height);
+  glState->vtkglClearColor(0.0, 0.0, 0.0, 0.0);
+  glState->vtkglClearDepth(1.0);
+  glState->vtkglDepthMask(GL_TRUE);
+  glState->vtkglClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  vtkRenderState framebufferState(state->GetRenderer());
+  framebufferState.SetPropArrayAndCount(state->GetPropArray(), state->GetPropArrayCount());
+  framebufferState.SetFrameBuffer(this->m_framebuffer);
+  framebufferState.SetRequiredKeys(state->GetRequiredKeys());
+  this->m_delegatePass->Render(&framebufferState);
+  this->NumberOfRenderedProps = this->m_delegatePass->GetNumberOfRenderedProps();
+
+  glState->PopFramebufferBindings();
+}
+
+void vtkMRMLLayerDMCachedRenderPass::CompositeFramebuffer(vtkOpenGLRenderWindow* renderWindow, int x, int y, int width, int height) const
+{
+  auto colorTexture = this->m_framebuffer ? this->m_framebuffer->GetColorAttachmentAsTextureObject(0) : nullptr;
+  if (!colorTexture)
+  {
+    return;
+  }
+
+  // Cached colors are premultiplied by the alpha blending of the offscreen rendering over transparent black
+  auto glState = renderWindow->GetState();
+  vtkOpenGLState::ScopedglViewport viewportSaver(glState);
+  vtkOpenGLState::ScopedglScissor scissorSaver(glState);
+  vtkOpenGLState::ScopedglBlendFuncSeparate blendFuncSaver(glState);
+  vtkOpenGLState::ScopedglDepthMask depthMaskSaver(glState);
+  vtkOpenGLState::ScopedglEnableDisable blendSaver(glState, GL_BLEND);
+  vtkOpenGLState::ScopedglEnableDisable depthTestSaver(glState, GL_DEPTH_TEST);
+
+  glState->vtkglViewport(x, y, width, height);
+  glState->vtkglScissor(x, y, width, height);
+  glState->vtkglEnable(GL_BLEND);
+  glState->vtkglBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  glState->vtkglDisable(GL_DEPTH_TEST);
+  glState->vtkglDepthMask(GL_FALSE);
+
+  colorTexture->CopyToFrameBuffer(nullptr, nullptr);
+}
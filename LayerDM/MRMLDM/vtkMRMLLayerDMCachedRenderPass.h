@@ -0,0 +1,78 @@
+#pragma once
+
+#include "vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkRenderPass.h>
+#include <vtkSmartPointer.h>
+
+class vtkOpenGLFramebufferObject;
+class vtkOpenGLRenderWindow;
+class vtkRenderer;
+class vtkRenderStepsPass;
+
+/// \brief Render pass caching the rendering of its renderer in an offscreen framebuffer.
+///
+/// The renderer props are rendered using a vtkRenderStepsPass in an offscreen RGBA framebuffer cleared to transparent
+/// black. The framebuffer color texture is then composited on the render window using premultiplied alpha blending.
+///
+/// On the next frames, the offscreen rendering is skipped and the cached texture is composited again as long as :
+///   - the renderer props, their visibility and their redraw MTime (prop, mapper and mapper input) didn't change
+///   - the renderer and its active camera didn't change
+///   - the renderer size didn't change
+///
+/// During hardware selection (\sa vtkRenderer::PickProp, vtkHardwareSelector), the props are rendered directly by the
+/// vtkRenderStepsPass without using nor updating the cache. These renders are neither counted as hits nor as misses.
+///
+/// Intended for overlay layers which rarely change (rulers, annotations, legends...) while the default layer is being
+/// interacted with. Only uses OpenGL framebuffer objects and is compatible with software rendering (Mesa / OSMesa).
+///
+/// \sa vtkMRMLLayerDMLayerManager::SetRenderOrderCached
+class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMCachedRenderPass : public vtkRenderPass
+{
+public:
+  static vtkMRMLLayerDMCachedRenderPass* New();
+  vtkTypeMacro(vtkMRMLLayerDMCachedRenderPass, vtkRenderPass);
+
+  void Render(const vtkRenderState* state) override;
+  void ReleaseGraphicsResources(vtkWindow* window) override;
+
+  /// Forces the rendering of the renderer props on the next frame.
+  void InvalidateCache();
+
+  /// @{
+  /// Cache statistics. Hits count the frames composited from the cache, misses the frames requiring an offscreen
+  /// rendering of the renderer props.
+  int GetNumberOfCacheHits() const;
+  int GetNumberOfCacheMisses() const;
+  void ResetCacheStatistics();
+  /// @}
+
+protected:
+  vtkMRMLLayerDMCachedRenderPass();
+  ~vtkMRMLLayerDMCachedRenderPass() override;
+
+private:
+  /// MTimes and size the cached image was rendered with
+  struct Signature
+  {
+    vtkMTimeType PropsMTime{ 0 };
+    vtkMTimeType RendererMTime{ 0 };
+    vtkMTimeType CameraMTime{ 0 };
+    int Width{ 0 };
+    int Height{ 0 };
+
+    bool operator==(const Signature& other) const;
+  };
+
+  static Signature ComputeSignature(vtkRenderer* renderer, int width, int height);
+  void RenderToFramebuffer(const vtkRenderState* state, vtkOpenGLRenderWindow* renderWindow, int width, int height);
+  void CompositeFramebuffer(vtkOpenGLRenderWindow* renderWindow, int x, int y, int width, int height) const;
+
+  vtkSmartPointer<vtkRenderStepsPass> m_delegatePass;
+  vtkSmartPointer<vtkOpenGLFramebufferObject> m_framebuffer;
+  Signature m_signature;
+  bool m_isCacheValid{ false };
+  int m_nCacheHits{ 0 };
+  int m_nCacheMisses{ 0 };
+};
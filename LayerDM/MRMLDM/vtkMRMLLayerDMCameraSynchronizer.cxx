@@ -2,6 +2,7 @@
 
 // Layer DM includes
 #include "vtkMRMLLayerDMObjectEventObserver.h"
+#include "vtkMRMLLayerDMTracer.h"
 
 // Slicer includes
 #include "vtkMRMLAbstractViewNode.h"
@@ -22,8 +23,9 @@
 class CameraSynchronizeStrategy
 {
 public:
-  explicit CameraSynchronizeStrategy(const vtkSmartPointer<vtkCamera>& camera, std::function<void()> invokeModifiedEvent)
+  explicit CameraSynchronizeStrategy(const vtkSmartPointer<vtkCamera>& camera, vtkMRMLAbstractViewNode* viewNode, std::function<void()> invokeModifiedEvent)
     : m_camera(camera)
+    , m_viewNode(viewNode)
     , m_invokeModifiedEvent{ std::move(invokeModifiedEvent) }
   {
   }
@@ -32,6 +34,7 @@ public:
 
 protected:
   vtkSmartPointer<vtkCamera> m_camera;
+  vtkWeakPointer<vtkMRMLAbstractViewNode> m_viewNode;
   vtkNew<vtkMRMLLayerDMObjectEventObserver> m_eventObserver;
   std::function<void()> m_invokeModifiedEvent;
 };
@@ -40,8 +43,11 @@ protected:
 class DefaultCameraSynchronizeStrategy : public CameraSynchronizeStrategy
 {
 public:
-  explicit DefaultCameraSynchronizeStrategy(const vtkSmartPointer<vtkCamera>& camera, vtkRenderer* renderer, std::function<void()> invokeModifiedEvent)
-    : CameraSynchronizeStrategy(camera, std::move(invokeModifiedEvent))
+  explicit DefaultCameraSynchronizeStrategy(const vtkSmartPointer<vtkCamera>& camera,
+                                            vtkMRMLAbstractViewNode* viewNode,
+                                            vtkRenderer* renderer,
+                                            std::function<void()> invokeModifiedEvent)
+    : CameraSynchronizeStrategy(camera, viewNode, std::move(invokeModifiedEvent))
     , m_renderer(renderer)
   {
     this->m_eventObserver->SetUpdateCallback(
@@ -65,6 +71,9 @@ public:
       return;
     }
 
+    vtkMRMLLayerDMTracer::Scope traceScope{ "CameraSync", "camera" };
+    traceScope.SetView(this->m_viewNode);
+
     // Update camera and preserve clipping range
     double clippingRange[2];
     this->m_camera->GetClippingRange(clippingRange);
@@ -104,7 +113,7 @@ class SliceViewCameraSynchronizeStrategy : public CameraSynchronizeStrategy
 {
 public:
   explicit SliceViewCameraSynchronizeStrategy(const vtkSmartPointer<vtkCamera>& camera, vtkMRMLSliceNode* sliceNode, std::function<void()> invokeModifiedEvent)
-    : CameraSynchronizeStrategy(camera, std::move(invokeModifiedEvent))
+    : CameraSynchronizeStrategy(camera, sliceNode, std::move(invokeModifiedEvent))
     , m_sliceNode{ sliceNode }
   {
     this->m_eventObserver->SetUpdateCallback(
@@ -125,6 +134,9 @@ public:
       return;
     }
 
+    vtkMRMLLayerDMTracer::Scope traceScope{ "CameraSync", "camera" };
+    traceScope.SetView(this->m_sliceNode);
+
     // Compute view center
     vtkMatrix4x4* xyToRas = this->m_sliceNode->GetXYToRAS();
     std::array<double, 4> viewCenterXY = { 0.5 * this->m_sliceNode->GetDimensions()[0], 0.5 * this->m_sliceNode->GetDimensions()[1], 0.0, 1.0 };
@@ -232,7 +244,7 @@ void vtkMRMLLayerDMCameraSynchronizer::UpdateStrategy()
   }
   else
   {
-    this->m_syncStrategy = std::make_unique<DefaultCameraSynchronizeStrategy>(this->m_defaultCamera, this->m_renderer, invokeModifiedEvent);
+    this->m_syncStrategy = std::make_unique<DefaultCameraSynchronizeStrategy>(this->m_defaultCamera, this->m_viewNode, this->m_renderer, invokeModifiedEvent);
   }
   this->m_syncStrategy->UpdateCamera();
 }
@@ -0,0 +1,236 @@
+#include "vtkMRMLLayerDMInteractionLatency.h"
+
+// VTK includes
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+
+// STL includes
+#include <algorithm>
+#include <sstream>
+
+vtkStandardNewMacro(vtkMRMLLayerDMInteractionLatency);
+
+namespace
+{
+bool MatchesPipelineClass(const std::string& pipelineClass, const char* filter)
+{
+  return !filter || filter[0] == '\0' || pipelineClass == filter;
+}
+
+constexpr std::size_t MaxPendingRenders = 256;
+
+double ElapsedSeconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+  return std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+void vtkMRMLLayerDMInteractionLatency::SetEnabled(bool isEnabled)
+{
+  if (this->m_isEnabled == isEnabled)
+  {
+    return;
+  }
+
+  this->m_isEnabled = isEnabled;
+  this->m_isEventPending = false;
+  this->m_pendingRenders.clear();
+  this->Modified();
+}
+
+bool vtkMRMLLayerDMInteractionLatency::IsEnabled() const
+{
+  return this->m_isEnabled;
+}
+
+void vtkMRMLLayerDMInteractionLatency::BeginEvent(unsigned long eventType)
+{
+  if (!this->m_isEnabled)
+  {
+    return;
+  }
+
+  this->m_isEventPending = true;
+  this->m_hasEventRequestedRender = false;
+  this->m_eventType = eventType;
+  this->m_eventStart = Clock::now();
+}
+
+void vtkMRMLLayerDMInteractionLatency::EndProcessing(vtkObject* pipeline)
+{
+  if (!this->m_isEnabled || !this->m_isEventPending)
+  {
+    return;
+  }
+
+  const auto processingEnd = Clock::now();
+  this->m_isEventPending = false;
+  const char* pipelineClass = pipeline ? pipeline->GetClassName() : "";
+  this->GetHistogram(ProcessingLatency, this->m_eventType, pipelineClass).RecordValue(ElapsedSeconds(this->m_eventStart, processingEnd));
+  auto& renderHistogram = this->GetHistogram(RenderLatency, this->m_eventType, pipelineClass);
+
+  // Only the events which requested a render during their processing wait for the render.
+  // Renders requested without ever being started (for instance without render window) are not kept indefinitely.
+  if (this->m_hasEventRequestedRender && this->m_pendingRenders.size() < MaxPendingRenders)
+  {
+    this->m_pendingRenders.push_back({ this->m_eventStart, processingEnd, &renderHistogram });
+  }
+}
+
+void vtkMRMLLayerDMInteractionLatency::OnRenderRequested()
+{
+  if (!this->m_isEnabled)
+  {
+    return;
+  }
+
+  // Render requests outside of an event processing are not attributed to the pending events
+  if (this->m_isEventPending)
+  {
+    this->m_hasEventRequestedRender = true;
+  }
+}
+
+void vtkMRMLLayerDMInteractionLatency::OnRenderStarted()
+{
+  if (!this->m_isEnabled || this->m_pendingRenders.empty())
+  {
+    return;
+  }
+
+  const auto renderStart = Clock::now();
+  for (const auto& pendingRender : this->m_pendingRenders)
+  {
+    pendingRender.Histogram->RecordValue(ElapsedSeconds(pendingRender.ProcessingEnd, renderStart));
+  }
+  this->m_pendingRenders.clear();
+}
+
+layer_dm::LatencyHistogram& vtkMRMLLayerDMInteractionLatency::GetHistogram(int stage, unsigned long eventType, const char* pipelineClass)
+{
+  auto& stageHistograms = this->m_histograms[stage];
+  auto classHistograms = stageHistograms.find(pipelineClass);
+  if (classHistograms == stageHistograms.end())
+  {
+    classHistograms = stageHistograms.emplace(pipelineClass, std::map<unsigned long, layer_dm::LatencyHistogram>{}).first;
+    if (std::find(this->m_pipelineClasses.begin(), this->m_pipelineClasses.end(), pipelineClass) == this->m_pipelineClasses.end())
+    {
+      this->m_pipelineClasses.emplace_back(pipelineClass);
+    }
+  }
+
+  if (std::find(this->m_eventTypes.begin(), this->m_eventTypes.end(), eventType) == this->m_eventTypes.end())
+  {
+    this->m_eventTypes.push_back(eventType);
+  }
+  return classHistograms->second[eventType];
+}
+
+layer_dm::LatencyHistogram vtkMRMLLayerDMInteractionLatency::MergeHistograms(int stage, unsigned long eventType, const char* pipelineClass) const
+{
+  layer_dm::LatencyHistogram merged;
+  if (stage < 0 || stage >= NumberOfLatencyStages)
+  {
+    return merged;
+  }
+
+  for (const auto& [histogramClass, classHistograms] : this->m_histograms[stage])
+  {
+    if (!MatchesPipelineClass(histogramClass, pipelineClass))
+    {
+      continue;
+    }
+
+    for (const auto& [histogramEventType, histogram] : classHistograms)
+    {
+      if (eventType == 0 || histogramEventType == eventType)
+      {
+        merged.Merge(histogram);
+      }
+    }
+  }
+  return merged;
+}
+
+double vtkMRMLLayerDMInteractionLatency::GetLatencyPercentile(int stage, double percentile, unsigned long eventType, const char* pipelineClass) const
+{
+  return this->MergeHistograms(stage, eventType, pipelineClass).GetValueAtPercentile(percentile);
+}
+
+int vtkMRMLLayerDMInteractionLatency::GetNumberOfLatencies(int stage, unsigned long eventType, const char* pipelineClass) const
+{
+  return static_cast<int>(this->MergeHistograms(stage, eventType, pipelineClass).GetTotalCount());
+}
+
+int vtkMRMLLayerDMInteractionLatency::GetNumberOfEventTypes() const
+{
+  return static_cast<int>(this->m_eventTypes.size());
+}
+
+unsigned long vtkMRMLLayerDMInteractionLatency::GetNthEventType(int iEventType) const
+{
+  if (iEventType < 0 || iEventType >= this->GetNumberOfEventTypes())
+  {
+    return 0;
+  }
+  return this->m_eventTypes[iEventType];
+}
+
+int vtkMRMLLayerDMInteractionLatency::GetNumberOfPipelineClasses() const
+{
+  return static_cast<int>(this->m_pipelineClasses.size());
+}
+
+const char* vtkMRMLLayerDMInteractionLatency::GetNthPipelineClass(int iPipelineClass) const
+{
+  if (iPipelineClass < 0 || iPipelineClass >= this->GetNumberOfPipelineClasses())
+  {
+    return nullptr;
+  }
+  return this->m_pipelineClasses[iPipelineClass].c_str();
+}
+
+std::string vtkMRMLLayerDMInteractionLatency::GetLatencyReport() const
+{
+  std::ostringstream report;
+  for (int iStage = 0; iStage < NumberOfLatencyStages; iStage++)
+  {
+    for (const auto& [pipelineClass, classHistograms] : this->m_histograms[iStage])
+    {
+      for (const auto& [eventType, histogram] : classHistograms)
+      {
+        if (histogram.GetTotalCount() == 0)
+        {
+          continue;
+        }
+
+        report << GetLatencyStageName(iStage) << " " << vtkCommand::GetStringFromEventId(eventType) << " " << pipelineClass
+               << ": count=" << histogram.GetTotalCount() << " p50=" << histogram.GetValueAtPercentile(50) * 1000.
+               << "ms p95=" << histogram.GetValueAtPercentile(95) * 1000. << "ms p99=" << histogram.GetValueAtPercentile(99) * 1000. << "ms\n";
+      }
+    }
+  }
+  return report.str();
+}
+
+void vtkMRMLLayerDMInteractionLatency::Reset()
+{
+  for (auto& stageHistograms : this->m_histograms)
+  {
+    stageHistograms.clear();
+  }
+  this->m_pendingRenders.clear();
+  this->m_eventTypes.clear();
+  this->m_pipelineClasses.clear();
+  this->m_isEventPending = false;
+}
+
+const char* vtkMRMLLayerDMInteractionLatency::GetLatencyStageName(int stage)
+{
+  switch (stage)
+  {
+    case ProcessingLatency: return "Processing";
+    case RenderLatency: return "Render";
+    default: return "";
+  }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h"
+
+// Layer DM includes
+#include "vtkMRMLLayerDMLatencyHistogram.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STL includes
+#include <array>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/// \brief Records the end-to-end interaction latencies of a view in latency histograms.
+///
+/// Two stages are measured for each interaction event processed by a pipeline :
+///   - ProcessingLatency: from the event entering \sa vtkMRMLLayerDisplayableManager::CanProcessInteractionEvent to the
+///     return of the pipeline which processed it.
+///   - RenderLatency: from the processing pipeline return to the start of the render requested by the processing.
+///     Render requests are asynchronous, the latency covers the request scheduling until the frame starts rendering.
+///     Only the events which requested a render between \sa BeginEvent and \sa EndProcessing are recorded in this stage.
+///
+/// Latencies are broken down by event type and by processing pipeline class. Queries can filter on both, on one of
+/// them or on none (0 event type and nullptr / empty pipeline class match all).
+///
+/// Recording is disabled by default. When disabled, the recording calls only check the enabled flag.
+/// \sa vtkMRMLLayerDMPipelineManager::GetInteractionLatency
+class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMInteractionLatency : public vtkObject
+{
+public:
+  static vtkMRMLLayerDMInteractionLatency* New();
+  vtkTypeMacro(vtkMRMLLayerDMInteractionLatency, vtkObject);
+
+  enum LatencyStage
+  {
+    ProcessingLatency = 0,
+    RenderLatency,
+    NumberOfLatencyStages
+  };
+
+  /// @{
+  /// Enable / disable the latency recording. Disabling the recording keeps the recorded latencies.
+  void SetEnabled(bool isEnabled);
+  bool IsEnabled() const;
+  /// @}
+
+  /// @{
+  /// Recording entry points.
+  /// \sa BeginEvent is called when an event enters the displayable manager, \sa EndProcessing when a pipeline processed
+  /// it. \sa OnRenderRequested and \sa OnRenderStarted are called by the pipeline manager.
+  void BeginEvent(unsigned long eventType);
+  void EndProcessing(vtkObject* pipeline);
+  void OnRenderRequested();
+  void OnRenderStarted();
+  /// @}
+
+  /// Returns the latency in seconds of the input percentile (in [0, 100]) for the input stage, event type and pipeline
+  /// class. Returns 0 if no latency matches.
+  double GetLatencyPercentile(int stage, double percentile, unsigned long eventType = 0, const char* pipelineClass = nullptr) const;
+
+  /// Returns the number of recorded latencies for the input stage, event type and pipeline class.
+  int GetNumberOfLatencies(int stage, unsigned long eventType = 0, const char* pipelineClass = nullptr) const;
+
+  /// @{
+  /// Event types and pipeline classes with recorded latencies.
+  int GetNumberOfEventTypes() const;
+  unsigned long GetNthEventType(int iEventType) const;
+  int GetNumberOfPipelineClasses() const;
+  const char* GetNthPipelineClass(int iPipelineClass) const;
+  /// @}
+
+  /// Returns a text report of the p50 / p95 / p99 latencies per stage, event type and pipeline class.
+  std::string GetLatencyReport() const;
+
+  /// Clear the recorded latencies.
+  void Reset();
+
+  /// Returns the name of the input \sa LatencyStage.
+  static const char* GetLatencyStageName(int stage);
+
+protected:
+  vtkMRMLLayerDMInteractionLatency() = default;
+  ~vtkMRMLLayerDMInteractionLatency() override = default;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /// Histograms per pipeline class and event type
+  using StageHistograms = std::map<std::string, std::map<unsigned long, layer_dm::LatencyHistogram>, std::less<>>;
+
+  /// Processed event waiting for its render
+  struct PendingRender
+  {
+    Clock::time_point EventStart;
+    Clock::time_point ProcessingEnd;
+    layer_dm::LatencyHistogram* Histogram;
+  };
+
+  layer_dm::LatencyHistogram& GetHistogram(int stage, unsigned long eventType, const char* pipelineClass);
+  layer_dm::LatencyHistogram MergeHistograms(int stage, unsigned long eventType, const char* pipelineClass) const;
+
+  bool m_isEnabled{ false };
+  bool m_isEventPending{ false };
+  bool m_hasEventRequestedRender{ false };
+  unsigned long m_eventType{ 0 };
+  Clock::time_point m_eventStart;
+  std::array<StageHistograms, NumberOfLatencyStages> m_histograms;
+  std::vector<PendingRender> m_pendingRenders;
+  std::vector<unsigned long> m_eventTypes;
+  std::vector<std::string> m_pipelineClasses;
+};
@@ -2,13 +2,21 @@
 
 // Layer DM includes
 #include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMTracer.h"
 
 // Slicer includes
 #include "vtkMRMLAbstractWidget.h"
 #include "vtkMRMLInteractionEventData.h"
+#include "vtkMRMLSliceNode.h"
 
 // VTK includes
+#include <vtkInteractorObserver.h>
 #include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+
+// STL includes
+#include <algorithm>
+#include <thread>
 
 vtkStandardNewMacro(vtkMRMLLayerDMInteractionLogic);
 
@@ -21,6 +29,18 @@ vtkMRMLLayerDMInteractionLogic::vtkMRMLLayerDMInteractionLogic()
   : m_prevFocusedPipeline{ nullptr }
   , m_canProcess{}
   , m_viewNode{ nullptr }
+  , m_isHierarchyOutdated{ true }
+  , m_nPolledPipelines{ 0 }
+  , m_coalescedMouseMove{ nullptr }
+  , m_isMouseMoveCoalescingEnabled{ false }
+  , m_isRenderPending{ false }
+  , m_isCoalescingCurrentEvent{ false }
+  , m_wasLastMouseMoveProcessed{ false }
+  , m_lastMouseMoveDistance2{ std::numeric_limits<double>::max() }
+  , m_nDroppedMouseMoves{ 0 }
+  , m_concurrentPollingThreshold{ 256 }
+  , m_nPollingThreads{ static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2)) }
+  , m_nConcurrentlyPolledPipelines{ 0 }
 {
 }
 
@@ -31,6 +51,9 @@ int vtkMRMLLayerDMInteractionLogic::MinWidgetState()
 
 void vtkMRMLLayerDMInteractionLogic::LoseFocus(vtkMRMLInteractionEventData* eventData)
 {
+  // When the focus moves to another displayable manager, the coalesced move belongs to it and must not be forwarded
+  this->DropCoalescedMouseMove();
+
   if (this->m_prevFocusedPipeline)
   {
     this->m_prevFocusedPipeline->LoseFocus(eventData);
@@ -51,46 +74,357 @@ void vtkMRMLLayerDMInteractionLogic::SetViewNode(vtkMRMLAbstractViewNode* viewNo
   this->m_viewNode = viewNode;
 }
 
-std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineI>> vtkMRMLLayerDMInteractionLogic::GetCanProcessPipelines() const
+int vtkMRMLLayerDMInteractionLogic::GetNumberOfCanProcessPipelines() const
+{
+  return static_cast<int>(this->m_canProcess.size());
+}
+
+vtkMRMLLayerDMPipelineI* vtkMRMLLayerDMInteractionLogic::GetNthCanProcessPipeline(int iPipeline) const
+{
+  if (iPipeline < 0 || iPipeline >= this->GetNumberOfCanProcessPipelines())
+  {
+    return nullptr;
+  }
+  return this->m_canProcess[iPipeline].Pipeline;
+}
+
+bool vtkMRMLLayerDMInteractionLogic::PollPipeline(vtkMRMLLayerDMPipelineI* pipeline, vtkMRMLInteractionEventData* eventData, double& distance2)
+{
+  this->m_nPolledPipelines++;
+  return CallCanProcessInteractionEvent(pipeline, eventData, distance2);
+}
+
+bool vtkMRMLLayerDMInteractionLogic::CallCanProcessInteractionEvent(vtkMRMLLayerDMPipelineI* pipeline, vtkMRMLInteractionEventData* eventData,
+                                                                    double& distance2)
+{
+  // Tracer buffers are per thread and performance counters are per pipeline, both can be recorded from the workers
+  vtkMRMLLayerDMTracer::Scope traceScope{ "CanProcessInteractionEvent", "interaction" };
+  traceScope.SetNode(pipeline->GetDisplayNode()).SetPipeline(pipeline).SetView(pipeline->GetViewNode());
+  vtkMRMLLayerDMPipelineI::PerformanceCounterGuard counterGuard{ pipeline, vtkMRMLLayerDMPipelineI::CanProcessInteractionEventDispatch };
+  return pipeline->CanProcessInteractionEvent(eventData, distance2);
+}
+
+bool vtkMRMLLayerDMInteractionLogic::PollActiveFocusedPipeline(vtkMRMLInteractionEventData* eventData, const vtkMRMLLayerDMPipelineI*& polledPipeline)
 {
-  return this->m_canProcess;
+  vtkMRMLLayerDMPipelineI* pipeline = this->m_prevFocusedPipeline;
+  if (!pipeline || pipeline->IsInteractionProcessingBlocked())
+  {
+    return false;
+  }
+
+  const int widgetState = pipeline->GetWidgetState();
+  if (widgetState <= this->MinWidgetState())
+  {
+    return false;
+  }
+
+  polledPipeline = pipeline;
+  double pipelineDistance = std::numeric_limits<double>::max();
+  if (!this->PollPipeline(pipeline, eventData, pipelineDistance))
+  {
+    return false;
+  }
+
+  this->m_canProcess.push_back({ pipeline, std::make_tuple(widgetState, pipeline->GetRenderOrder(), -pipelineDistance) });
+  return true;
 }
 
-std::tuple<double, int> vtkMRMLLayerDMInteractionLogic::PrioritizeCanProcessPipelines(vtkMRMLInteractionEventData* eventData)
+std::tuple<double, int> vtkMRMLLayerDMInteractionLogic::PrioritizeCanProcessPipelines(vtkMRMLInteractionEventData* eventData,
+                                                                                      const vtkMRMLLayerDMPipelineI* polledPipeline)
 {
-  // For each pipeline, if pipeline can process, store its state value, layer and distance to interaction
-  std::map<vtkMRMLLayerDMPipelineI*, std::tuple<int, unsigned int, double>> priority;
+  this->CollectInteractionCandidates(eventData);
+  this->PollCandidates(eventData, polledPipeline);
+
+  // For each pipeline, if pipeline can process, store its state value, layer and distance to interaction.
+  // Results are merged in the candidates order whatever the thread which polled them to keep the priority ties deterministic.
   double minDistance = std::numeric_limits<double>::max();
   int maxState = this->MinWidgetState();
-  for (const auto& pipeline : m_pipelines)
+  for (std::size_t iCandidate = 0; iCandidate < this->m_candidates.size(); ++iCandidate)
+  {
+    const auto& result = this->m_pollResults[iCandidate];
+    if (!result.CanProcess)
+    {
+      continue;
+    }
+
+    vtkMRMLLayerDMPipelineI* pipeline = this->m_pipelines[this->m_candidates[iCandidate]];
+    int widgetState = std::max(this->MinWidgetState(), pipeline->GetWidgetState());
+    minDistance = std::min(minDistance, result.Distance2);
+    maxState = std::max(widgetState, maxState);
+    this->m_canProcess.push_back({ pipeline, std::make_tuple(widgetState, pipeline->GetRenderOrder(), -result.Distance2) });
+  }
+
+  // Candidates are not sorted. \sa ProcessInteractionEvent extracts the best remaining candidate until one processes the event.
+  return std::make_tuple(minDistance, maxState);
+}
+
+void vtkMRMLLayerDMInteractionLogic::PollCandidates(vtkMRMLInteractionEventData* eventData, const vtkMRMLLayerDMPipelineI* polledPipeline)
+{
+  this->m_pollResults.assign(this->m_candidates.size(), { false, std::numeric_limits<double>::max() });
+  this->m_reentrantCandidates.clear();
+
+  // Pipelines which are not reentrant are polled on the main thread first
+  for (std::size_t iCandidate = 0; iCandidate < this->m_candidates.size(); ++iCandidate)
   {
-    if (pipeline->IsInteractionProcessingBlocked())
+    vtkMRMLLayerDMPipelineI* pipeline = this->m_pipelines[this->m_candidates[iCandidate]];
+    if (pipeline == polledPipeline || pipeline->IsInteractionProcessingBlocked())
     {
       continue;
     }
 
-    double pipelineDistance = std::numeric_limits<double>::max();
-    if (pipeline->CanProcessInteractionEvent(eventData, pipelineDistance))
+    if (pipeline->IsReentrantCanProcessInteractionEvent())
     {
-      this->m_canProcess.emplace_back(pipeline);
-      int widgetState = std::max(this->MinWidgetState(), pipeline->GetWidgetState());
-      minDistance = std::min(minDistance, pipelineDistance);
-      maxState = std::max(widgetState, maxState);
-      priority[pipeline] = std::make_tuple(widgetState, pipeline->GetRenderOrder(), -pipelineDistance);
+      this->m_reentrantCandidates.push_back(static_cast<int>(iCandidate));
+      continue;
     }
+
+    auto& result = this->m_pollResults[iCandidate];
+    result.CanProcess = this->PollPipeline(pipeline, eventData, result.Distance2);
   }
-  // Sort can process by layer order and inverted square distance (larger layer number first and closest to interaction)
-  std::sort(this->m_canProcess.begin(),
-            this->m_canProcess.end(),
-            [&priority](const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& a, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& b) { return priority[a] > priority[b]; });
 
-  return std::make_tuple(minDistance, maxState);
+  const int nReentrant = static_cast<int>(this->m_reentrantCandidates.size());
+  if (this->m_concurrentPollingThreshold > 0 && nReentrant >= this->m_concurrentPollingThreshold)
+  {
+    this->PollReentrantCandidatesConcurrently(eventData);
+    return;
+  }
+
+  for (int iCandidate : this->m_reentrantCandidates)
+  {
+    auto& result = this->m_pollResults[iCandidate];
+    result.CanProcess = this->PollPipeline(this->m_pipelines[this->m_candidates[iCandidate]], eventData, result.Distance2);
+  }
+}
+
+void vtkMRMLLayerDMInteractionLogic::PollReentrantCandidatesConcurrently(vtkMRMLInteractionEventData* eventData)
+{
+  if (!this->m_pollingPool)
+  {
+    this->m_pollingPool = std::make_unique<layer_dm::WorkStealingThreadPool>(this->m_nPollingThreads);
+  }
+
+  // One contiguous range of candidates per worker, each task writes the results of its own range only.
+  // The main thread waits for the workers, the pipelines and the event data are not modified during the polling.
+  const int nReentrant = static_cast<int>(this->m_reentrantCandidates.size());
+  const int nTasks = std::min(this->m_nPollingThreads, nReentrant);
+  for (int iTask = 0; iTask < nTasks; ++iTask)
+  {
+    const int begin = iTask * nReentrant / nTasks;
+    const int end = (iTask + 1) * nReentrant / nTasks;
+    this->m_pollingPool->Submit(
+      [this, eventData, begin, end]
+      {
+        for (int iReentrant = begin; iReentrant < end; ++iReentrant)
+        {
+          const int iCandidate = this->m_reentrantCandidates[iReentrant];
+          auto& result = this->m_pollResults[iCandidate];
+          result.CanProcess = CallCanProcessInteractionEvent(this->m_pipelines[this->m_candidates[iCandidate]], eventData, result.Distance2);
+        }
+      });
+  }
+  this->m_pollingPool->WaitIdle();
+
+  this->m_nPolledPipelines += nReentrant;
+  this->m_nConcurrentlyPolledPipelines = nReentrant;
+}
+
+void vtkMRMLLayerDMInteractionLogic::UpdateBoundingVolumeHierarchies()
+{
+  if (!this->m_isHierarchyOutdated)
+  {
+    return;
+  }
+
+  this->m_worldBoundedPipelines.clear();
+  this->m_displayBoundedPipelines.clear();
+  this->m_unboundedPipelines.clear();
+  this->m_customCameraWorldPipelines.clear();
+  this->m_isWorldItemCustomCamera.clear();
+  this->m_boundedPipelines.clear();
+
+  std::vector<layer_dm::BoundingVolumeHierarchy<3>::Box> worldBoxes;
+  std::vector<layer_dm::BoundingVolumeHierarchy<2>::Box> displayBoxes;
+  for (int iPipeline = 0; iPipeline < static_cast<int>(this->m_pipelines.size()); ++iPipeline)
+  {
+    const auto& pipeline = this->m_pipelines[iPipeline];
+    const int space = pipeline->GetInteractionBoundsSpace();
+    double bounds[6];
+    pipeline->GetInteractionBounds(bounds);
+    if (space == vtkMRMLLayerDMPipelineI::WorldInteractionBounds)
+    {
+      this->m_boundedPipelines[pipeline] = { space, static_cast<int>(worldBoxes.size()) };
+      worldBoxes.push_back({ bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] });
+      this->m_worldBoundedPipelines.push_back(iPipeline);
+      this->m_isWorldItemCustomCamera.push_back(pipeline->GetCustomCamera() != nullptr);
+      if (this->m_isWorldItemCustomCamera.back())
+      {
+        this->m_customCameraWorldPipelines.push_back(iPipeline);
+      }
+    }
+    else if (space == vtkMRMLLayerDMPipelineI::DisplayInteractionBounds)
+    {
+      this->m_boundedPipelines[pipeline] = { space, static_cast<int>(displayBoxes.size()) };
+      displayBoxes.push_back({ bounds[0], bounds[1], bounds[2], bounds[3] });
+      this->m_displayBoundedPipelines.push_back(iPipeline);
+    }
+    else
+    {
+      this->m_unboundedPipelines.push_back(iPipeline);
+    }
+  }
+
+  this->m_worldHierarchy.Build(worldBoxes);
+  this->m_displayHierarchy.Build(displayBoxes);
+  this->m_isHierarchyOutdated = false;
+}
+
+void vtkMRMLLayerDMInteractionLogic::CollectInteractionCandidates(vtkMRMLInteractionEventData* eventData)
+{
+  this->UpdateBoundingVolumeHierarchies();
+  this->m_candidates.assign(this->m_unboundedPipelines.begin(), this->m_unboundedPipelines.end());
+
+  // Bounded pipelines are only candidates if the event position is inside their bounds.
+  // Events without valid position are forwarded to all the pipelines.
+  if (!this->m_worldBoundedPipelines.empty())
+  {
+    const auto addWorldCandidate = [this](int item) { this->m_candidates.push_back(this->m_worldBoundedPipelines[item]); };
+    double rayStart[3], rayEnd[3];
+    if (vtkMRMLSliceNode::SafeDownCast(this->m_viewNode) && eventData->IsWorldPositionValid())
+    {
+      double worldPosition[3];
+      eventData->GetWorldPosition(worldPosition);
+      this->m_worldHierarchy.Query(worldPosition, addWorldCandidate);
+    }
+    else if (GetPickRay(eventData, rayStart, rayEnd))
+    {
+      // In 3D views, the world position is the picked surface which may be behind the pipelines.
+      // The pick ray is computed with the default camera, the pipelines using a custom camera are always candidates.
+      this->m_worldHierarchy.QuerySegment(rayStart,
+                                          rayEnd,
+                                          [this](int item)
+                                          {
+                                            if (!this->m_isWorldItemCustomCamera[item])
+                                            {
+                                              this->m_candidates.push_back(this->m_worldBoundedPipelines[item]);
+                                            }
+                                          });
+      this->m_candidates.insert(this->m_candidates.end(), this->m_customCameraWorldPipelines.begin(), this->m_customCameraWorldPipelines.end());
+    }
+    else
+    {
+      this->m_candidates.insert(this->m_candidates.end(), this->m_worldBoundedPipelines.begin(), this->m_worldBoundedPipelines.end());
+    }
+  }
+
+  if (!this->m_displayBoundedPipelines.empty())
+  {
+    if (eventData->IsDisplayPositionValid())
+    {
+      int displayPosition[2];
+      eventData->GetDisplayPosition(displayPosition);
+      const double position[2] = { static_cast<double>(displayPosition[0]), static_cast<double>(displayPosition[1]) };
+      this->m_displayHierarchy.Query(position, [this](int item) { this->m_candidates.push_back(this->m_displayBoundedPipelines[item]); });
+    }
+    else
+    {
+      this->m_candidates.insert(this->m_candidates.end(), this->m_displayBoundedPipelines.begin(), this->m_displayBoundedPipelines.end());
+    }
+  }
+
+  // The focused pipeline is always asked to let it end its interaction outside of its bounds
+  auto focused = this->m_boundedPipelines.find(this->m_prevFocusedPipeline);
+  if (focused != this->m_boundedPipelines.end())
+  {
+    const auto& boundedPipelines = focused->second.Space == vtkMRMLLayerDMPipelineI::WorldInteractionBounds ? this->m_worldBoundedPipelines : this->m_displayBoundedPipelines;
+    const int iFocused = boundedPipelines[focused->second.Item];
+    if (std::find(this->m_candidates.begin(), this->m_candidates.end(), iFocused) == this->m_candidates.end())
+    {
+      this->m_candidates.push_back(iFocused);
+    }
+  }
+
+  // Keep the pipeline addition order for the candidates
+  std::sort(this->m_candidates.begin(), this->m_candidates.end());
+}
+
+bool vtkMRMLLayerDMInteractionLogic::GetPickRay(vtkMRMLInteractionEventData* eventData, double start[3], double end[3])
+{
+  vtkRenderer* renderer = eventData->GetRenderer();
+  if (!renderer || !renderer->GetRenderWindow() || !eventData->IsDisplayPositionValid())
+  {
+    return false;
+  }
+
+  // Segment between the near and far clipping planes under the event display position
+  int displayPosition[2];
+  eventData->GetDisplayPosition(displayPosition);
+  double nearPoint[4], farPoint[4];
+  vtkInteractorObserver::ComputeDisplayToWorld(renderer, displayPosition[0], displayPosition[1], 0, nearPoint);
+  vtkInteractorObserver::ComputeDisplayToWorld(renderer, displayPosition[0], displayPosition[1], 1, farPoint);
+  std::copy_n(nearPoint, 3, start);
+  std::copy_n(farPoint, 3, end);
+  return true;
+}
+
+void vtkMRMLLayerDMInteractionLogic::UpdatePipelineInteractionBounds(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  if (!pipeline || this->m_isHierarchyOutdated)
+  {
+    return;
+  }
+
+  const int space = pipeline->GetInteractionBoundsSpace();
+  auto boundedPipeline = this->m_boundedPipelines.find(pipeline);
+  if (boundedPipeline == this->m_boundedPipelines.end())
+  {
+    // Unbounded pipelines setting new bounds require moving them to a hierarchy
+    this->m_isHierarchyOutdated = space != vtkMRMLLayerDMPipelineI::NoInteractionBounds;
+    return;
+  }
+
+  if (boundedPipeline->second.Space != space)
+  {
+    this->m_isHierarchyOutdated = true;
+    return;
+  }
+
+  double bounds[6];
+  pipeline->GetInteractionBounds(bounds);
+  if (space == vtkMRMLLayerDMPipelineI::WorldInteractionBounds)
+  {
+    this->m_worldHierarchy.Refit(boundedPipeline->second.Item, { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] });
+  }
+  else
+  {
+    this->m_displayHierarchy.Refit(boundedPipeline->second.Item, { bounds[0], bounds[1], bounds[2], bounds[3] });
+  }
+}
+
+void vtkMRMLLayerDMInteractionLogic::UpdatePipelineCustomCamera(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  if (!pipeline || this->m_isHierarchyOutdated)
+  {
+    return;
+  }
+
+  // World bounded pipelines switching between the default and a custom camera move in / out of the pick ray query
+  auto boundedPipeline = this->m_boundedPipelines.find(pipeline);
+  if (boundedPipeline != this->m_boundedPipelines.end() && boundedPipeline->second.Space == vtkMRMLLayerDMPipelineI::WorldInteractionBounds)
+  {
+    this->m_isHierarchyOutdated = this->m_isWorldItemCustomCamera[boundedPipeline->second.Item] != (pipeline->GetCustomCamera() != nullptr);
+  }
+}
+
+int vtkMRMLLayerDMInteractionLogic::GetNumberOfPolledPipelines() const
+{
+  return this->m_nPolledPipelines;
 }
 
 void vtkMRMLLayerDMInteractionLogic::LosePreviousFocusInCannotProcess(vtkMRMLInteractionEventData* eventData)
 {
   // Lose focus if previous focused pipeline cannot process current interaction
-  if (std::find(this->m_canProcess.begin(), this->m_canProcess.end(), this->m_prevFocusedPipeline) == this->m_canProcess.end())
+  const auto isFocused = [this](const Candidate& candidate) { return candidate.Pipeline == this->m_prevFocusedPipeline; };
+  if (std::none_of(this->m_canProcess.begin(), this->m_canProcess.end(), isFocused))
   {
     this->LoseFocus(eventData);
   }
@@ -103,6 +437,13 @@ void vtkMRMLLayerDMInteractionLogic::AddPipeline(const vtkSmartPointer<vtkMRMLLa
     return;
   }
   this->m_pipelines.emplace_back(pipeline);
+  this->m_isHierarchyOutdated = true;
+
+  // Preallocate the interaction buffers to avoid allocations during the interactions
+  this->m_candidates.reserve(this->m_pipelines.size());
+  this->m_canProcess.reserve(this->m_pipelines.size());
+  this->m_pollResults.reserve(this->m_pipelines.size());
+  this->m_reentrantCandidates.reserve(this->m_pipelines.size());
 }
 
 void vtkMRMLLayerDMInteractionLogic::RemovePipeline(const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline)
@@ -112,12 +453,53 @@ void vtkMRMLLayerDMInteractionLogic::RemovePipeline(const vtkSmartPointer<vtkMRM
     this->LoseFocus();
   }
   this->m_pipelines.erase(std::find(this->m_pipelines.begin(), this->m_pipelines.end(), pipeline));
+  this->m_isHierarchyOutdated = true;
+
+  // Pipelines may be removed while the event is processed, drop their candidate reference
+  for (auto& candidate : this->m_canProcess)
+  {
+    if (candidate.Pipeline == pipeline)
+    {
+      candidate.Pipeline = nullptr;
+    }
+  }
 }
 
 bool vtkMRMLLayerDMInteractionLogic::CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2)
+{
+  // A coalescing claim not followed by ProcessInteractionEvent was won by another displayable manager.
+  // Stop coalescing until the pipelines process a move again.
+  if (this->m_isCoalescingCurrentEvent)
+  {
+    this->m_isCoalescingCurrentEvent = false;
+    this->m_wasLastMouseMoveProcessed = false;
+  }
+
+  this->m_isCoalescingCurrentEvent = this->CanCoalesceMouseMove(eventData);
+  if (this->m_isCoalescingCurrentEvent)
+  {
+    distance2 = this->m_lastMouseMoveDistance2;
+    return true;
+  }
+
+  // Forward the coalesced move before the other events to keep the event order
+  this->FlushCoalescedMouseMove();
+
+  const bool canProcess = this->PollPipelines(eventData, distance2);
+  if (eventData->GetType() == vtkCommand::MouseMoveEvent)
+  {
+    this->m_lastMouseMoveDistance2 = distance2;
+    this->m_wasLastMouseMoveProcessed = false;
+  }
+  return canProcess;
+}
+
+bool vtkMRMLLayerDMInteractionLogic::PollPipelines(vtkMRMLInteractionEventData* eventData, double& distance2)
 {
   // Clear previous interaction list
   this->m_canProcess.clear();
+  this->m_nPolledPipelines = 0;
+  this->m_nConcurrentlyPolledPipelines = 0;
 
   // On leave event lose focus and early return to avoid bad pipeline state
   if (eventData->GetType() == vtkCommand::LeaveEvent)
@@ -126,8 +508,17 @@ bool vtkMRMLLayerDMInteractionLogic::CanProcessInteractionEvent(vtkMRMLInteracti
     return false;
   }
 
+  // Fast path: the focused pipeline in an active state (for instance dragging) keeps the exclusive focus as long as it
+  // can process the events. The other pipelines are not polled.
+  const vtkMRMLLayerDMPipelineI* polledPipeline = nullptr;
+  if (this->PollActiveFocusedPipeline(eventData, polledPipeline))
+  {
+    distance2 = std::numeric_limits<double>::lowest();
+    return true;
+  }
+
   // Refresh the can process pipelines and order them by priority
-  auto [minDistance, maxState] = this->PrioritizeCanProcessPipelines(eventData);
+  auto [minDistance, maxState] = this->PrioritizeCanProcessPipelines(eventData, polledPipeline);
 
   // Lose previous focus if not in can process list
   this->LosePreviousFocusInCannotProcess(eventData);
@@ -140,15 +531,52 @@ bool vtkMRMLLayerDMInteractionLogic::CanProcessInteractionEvent(vtkMRMLInteracti
 
 bool vtkMRMLLayerDMInteractionLogic::ProcessInteractionEvent(vtkMRMLInteractionEventData* eventData)
 {
-  for (const auto& pipeline : m_canProcess)
+  // Coalesced moves are only stored once the claim is won and are forwarded when the pending render starts
+  if (this->m_isCoalescingCurrentEvent)
+  {
+    this->m_isCoalescingCurrentEvent = false;
+    if (this->m_coalescedMouseMove)
+    {
+      this->m_nDroppedMouseMoves++;
+    }
+    this->m_coalescedMouseMove = eventData;
+    return true;
+  }
+
+  const bool didProcess = this->ProcessCandidates(eventData);
+  if (eventData->GetType() == vtkCommand::MouseMoveEvent)
+  {
+    this->m_wasLastMouseMoveProcessed = didProcess;
+  }
+  return didProcess;
+}
+
+bool vtkMRMLLayerDMInteractionLogic::ProcessCandidates(vtkMRMLInteractionEventData* eventData)
+{
+  // Candidates are ordered by widget state, layer order and inverted square distance (larger layer number first and
+  // closest to interaction). Extract the best remaining candidate until one processes the event instead of sorting
+  // all of them as the first candidate usually processes the event.
+  const auto hasLowerPriority = [](const Candidate& a, const Candidate& b) { return a.Priority < b.Priority; };
+  for (auto next = this->m_canProcess.begin(); next != this->m_canProcess.end(); ++next)
   {
-    if (pipeline->IsInteractionProcessingBlocked())
+    std::iter_swap(next, std::max_element(next, this->m_canProcess.end(), hasLowerPriority));
+
+    // Keep the pipeline alive during processing in case processing removes it
+    vtkSmartPointer<vtkMRMLLayerDMPipelineI> pipeline = next->Pipeline;
+    if (!pipeline || pipeline->IsInteractionProcessingBlocked())
     {
       continue;
     }
 
     // If pipeline can process, store pipeline for further interaction events
-    if (pipeline->ProcessInteractionEvent(eventData))
+    bool didProcess;
+    {
+      vtkMRMLLayerDMTracer::Scope traceScope{ "ProcessInteractionEvent", "interaction" };
+      traceScope.SetNode(pipeline->GetDisplayNode()).SetPipeline(pipeline).SetView(pipeline->GetViewNode());
+      vtkMRMLLayerDMPipelineI::PerformanceCounterGuard counterGuard{ pipeline, vtkMRMLLayerDMPipelineI::ProcessInteractionEventDispatch };
+      didProcess = pipeline->ProcessInteractionEvent(eventData);
+    }
+    if (didProcess)
     {
       if (pipeline != this->m_prevFocusedPipeline)
       {
@@ -163,3 +591,116 @@ bool vtkMRMLLayerDMInteractionLogic::ProcessInteractionEvent(vtkMRMLInteractionE
   this->LoseFocus(eventData);
   return false;
 }
+
+void vtkMRMLLayerDMInteractionLogic::SetMouseMoveCoalescing(bool isEnabled)
+{
+  if (this->m_isMouseMoveCoalescingEnabled == isEnabled)
+  {
+    return;
+  }
+
+  this->m_isMouseMoveCoalescingEnabled = isEnabled;
+  if (!isEnabled)
+  {
+    this->FlushCoalescedMouseMove();
+  }
+  this->Modified();
+}
+
+bool vtkMRMLLayerDMInteractionLogic::IsMouseMoveCoalescingEnabled() const
+{
+  return this->m_isMouseMoveCoalescingEnabled;
+}
+
+void vtkMRMLLayerDMInteractionLogic::SetRenderPending(bool isPending)
+{
+  this->m_isRenderPending = isPending;
+}
+
+bool vtkMRMLLayerDMInteractionLogic::CanCoalesceMouseMove(vtkMRMLInteractionEventData* eventData) const
+{
+  // Moves are only coalesced while the logic is processing the moves (hover or drag) and a render is pending.
+  // Otherwise, other displayable managers may be handling the moves and these must reach them.
+  return this->m_isMouseMoveCoalescingEnabled && this->m_isRenderPending && this->m_wasLastMouseMoveProcessed &&
+         eventData->GetType() == vtkCommand::MouseMoveEvent;
+}
+
+void vtkMRMLLayerDMInteractionLogic::DropCoalescedMouseMove()
+{
+  if (this->m_coalescedMouseMove)
+  {
+    this->m_nDroppedMouseMoves++;
+    this->m_coalescedMouseMove = nullptr;
+  }
+  this->m_isCoalescingCurrentEvent = false;
+  this->m_wasLastMouseMoveProcessed = false;
+}
+
+bool vtkMRMLLayerDMInteractionLogic::FlushCoalescedMouseMove()
+{
+  if (!this->m_coalescedMouseMove)
+  {
+    return false;
+  }
+
+  vtkSmartPointer<vtkMRMLInteractionEventData> mouseMove = this->m_coalescedMouseMove;
+  this->m_coalescedMouseMove = nullptr;
+
+  double distance2;
+  this->m_lastMouseMoveDistance2 = std::numeric_limits<double>::max();
+  this->m_wasLastMouseMoveProcessed = this->PollPipelines(mouseMove, distance2) && this->ProcessCandidates(mouseMove);
+  if (this->m_wasLastMouseMoveProcessed)
+  {
+    this->m_lastMouseMoveDistance2 = distance2;
+  }
+  return this->m_wasLastMouseMoveProcessed;
+}
+
+int vtkMRMLLayerDMInteractionLogic::GetNumberOfDroppedMouseMoves() const
+{
+  return this->m_nDroppedMouseMoves;
+}
+
+void vtkMRMLLayerDMInteractionLogic::ResetNumberOfDroppedMouseMoves()
+{
+  this->m_nDroppedMouseMoves = 0;
+}
+
+void vtkMRMLLayerDMInteractionLogic::SetConcurrentPollingThreshold(int threshold)
+{
+  if (this->m_concurrentPollingThreshold == threshold)
+  {
+    return;
+  }
+
+  this->m_concurrentPollingThreshold = threshold;
+  this->Modified();
+}
+
+int vtkMRMLLayerDMInteractionLogic::GetConcurrentPollingThreshold() const
+{
+  return this->m_concurrentPollingThreshold;
+}
+
+void vtkMRMLLayerDMInteractionLogic::SetNumberOfPollingThreads(int nThreads)
+{
+  nThreads = std::max(1, nThreads);
+  if (this->m_nPollingThreads == nThreads)
+  {
+    return;
+  }
+
+  this->m_nPollingThreads = nThreads;
+  this->m_pollingPool.reset();
+  this->Modified();
+}
+
+int vtkMRMLLayerDMInteractionLogic::GetNumberOfPollingThreads() const
+{
+  return this->m_nPollingThreads;
+}
+
+int vtkMRMLLayerDMInteractionLogic::GetNumberOfConcurrentlyPolledPipelines() const
+{
+  return this->m_nConcurrentlyPolledPipelines;
+}
@@ -2,12 +2,19 @@
 
 #include "vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h"
 
+// Layer DM includes
+#include "vtkMRMLLayerDMBoundingVolumeHierarchy.h"
+#include "vtkMRMLLayerDMThreadPool.h"
+
 // VTK includes
 #include <vtkObject.h>
 #include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
 // STL includes
+#include <memory>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 class vtkMRMLLayerDMPipelineI;
@@ -23,6 +30,22 @@ class vtkMRMLAbstractViewNode;
 ///   - Widget State if state is greater than WidgetStateOnWidget (indicates previously active display pipeline)
 ///   - Pipeline layer (higher = overlay on top of other renderers)
 ///   - Distance to interaction (min = closer to VTK event)
+///
+/// While the focused pipeline is in an active state (greater than WidgetStateOnWidget, for instance during a drag), it is
+/// polled alone and keeps the exclusive focus until it cannot process an event or goes back to an idle / hover state.
+///
+/// Pipelines publishing interaction bounds are stored in world and display bounding volume hierarchies. Only the
+/// pipelines whose bounds contain the event position, the pipelines without bounds and the focused pipeline are asked
+/// if they can process the event. In 3D views, the world bounds are tested against the pick ray of the event display
+/// position instead of the picked world position. The pick ray is computed with the default camera : world bounded
+/// pipelines using a custom camera are always candidates in 3D views.
+/// \sa vtkMRMLLayerDMPipelineI::SetWorldInteractionBounds
+///
+/// Candidates declaring a reentrant \sa vtkMRMLLayerDMPipelineI::CanProcessInteractionEvent are polled on worker threads
+/// when they are numerous enough \sa SetConcurrentPollingThreshold. The poll results are merged in the candidates order,
+/// the priorities are the same as with a sequential polling.
+///
+/// Optionally, the mouse moves arriving while a render is pending can be coalesced \sa SetMouseMoveCoalescing.
 class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMInteractionLogic : public vtkObject
 {
 public:
@@ -31,7 +54,15 @@ public:
 
   void AddPipeline(const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline);
   bool CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2);
-  std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineI>> GetCanProcessPipelines() const;
+
+  /// @{
+  /// Pipelines which can process the last interaction event.
+  /// The candidates are not sorted by priority, \sa ProcessInteractionEvent only extracts the best candidates until one
+  /// processes the event.
+  int GetNumberOfCanProcessPipelines() const;
+  vtkMRMLLayerDMPipelineI* GetNthCanProcessPipeline(int iPipeline) const;
+  /// @}
+
   vtkMRMLLayerDMPipelineI* GetLastFocusedPipeline() const;
   void LoseFocus(vtkMRMLInteractionEventData* eventData);
   void LoseFocus();
@@ -39,17 +70,139 @@ public:
   void RemovePipeline(const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline);
   void SetViewNode(vtkMRMLAbstractViewNode* viewNode);
 
+  /// Refit the bounding volume hierarchy with the current interaction bounds of the input pipeline.
+  /// Changing the bounds space of a pipeline triggers a rebuild of the hierarchies on the next event instead.
+  void UpdatePipelineInteractionBounds(vtkMRMLLayerDMPipelineI* pipeline);
+
+  /// Update the pick ray culling of the input pipeline after its custom camera changed.
+  void UpdatePipelineCustomCamera(vtkMRMLLayerDMPipelineI* pipeline);
+
+  /// Returns the number of pipelines asked if they can process the last interaction event.
+  int GetNumberOfPolledPipelines() const;
+
+  /// @{
+  /// Enable / disable the coalescing of the mouse moves arriving while a render is pending (default = false).
+  ///
+  /// When enabled and the last mouse move was processed by a pipeline, the following moves are consumed without
+  /// polling the pipelines until the pending render starts. The latest of these moves is then forwarded to the
+  /// pipelines by \sa FlushCoalescedMouseMove right before the render, the previous ones are dropped.
+  /// Any other event (button, key, leave...) forwards the coalesced move first to keep the event order, which keeps
+  /// drags consistent with their press and release positions.
+  ///
+  /// A move is only stored once \sa ProcessInteractionEvent confirms that the displayable manager won it. Claims won by
+  /// another displayable manager stop the coalescing, and losing the focus drops the stored move.
+  ///
+  /// \warning The coalesced move event data is kept until forwarded and must not be reused for the next events.
+  void SetMouseMoveCoalescing(bool isEnabled);
+  bool IsMouseMoveCoalescingEnabled() const;
+  /// @}
+
+  /// Set by the pipeline manager when a render is requested and reset when the render starts.
+  void SetRenderPending(bool isPending);
+
+  /// Forward the coalesced mouse move to the pipelines if any.
+  /// \return true if the coalesced move was processed.
+  bool FlushCoalescedMouseMove();
+
+  /// @{
+  /// Number of mouse moves dropped by the coalescing since the last reset.
+  int GetNumberOfDroppedMouseMoves() const;
+  void ResetNumberOfDroppedMouseMoves();
+  /// @}
+
+  /// @{
+  /// Minimum number of reentrant candidates for an event to poll them on the worker threads (default = 256).
+  /// Below the threshold, all the candidates are polled on the main thread. Values <= 0 disable the concurrent polling.
+  /// \sa vtkMRMLLayerDMPipelineI::SetReentrantCanProcessInteractionEvent
+  void SetConcurrentPollingThreshold(int threshold);
+  int GetConcurrentPollingThreshold() const;
+  /// @}
+
+  /// @{
+  /// Number of worker threads polling the reentrant candidates.
+  /// Default is half the hardware concurrency (at least 1). The workers are started on the first concurrent polling.
+  void SetNumberOfPollingThreads(int nThreads);
+  int GetNumberOfPollingThreads() const;
+  /// @}
+
+  /// Returns the number of pipelines polled on the worker threads for the last interaction event.
+  int GetNumberOfConcurrentlyPolledPipelines() const;
+
 protected:
   vtkMRMLLayerDMInteractionLogic();
   ~vtkMRMLLayerDMInteractionLogic() override = default;
 
 private:
   static int MinWidgetState();
-  std::tuple<double, int> PrioritizeCanProcessPipelines(vtkMRMLInteractionEventData* eventData);
+  bool CanCoalesceMouseMove(vtkMRMLInteractionEventData* eventData) const;
+  void DropCoalescedMouseMove();
+  bool PollPipelines(vtkMRMLInteractionEventData* eventData, double& distance2);
+  bool ProcessCandidates(vtkMRMLInteractionEventData* eventData);
+  bool PollPipeline(vtkMRMLLayerDMPipelineI* pipeline, vtkMRMLInteractionEventData* eventData, double& distance2);
+  static bool CallCanProcessInteractionEvent(vtkMRMLLayerDMPipelineI* pipeline, vtkMRMLInteractionEventData* eventData, double& distance2);
+  void PollCandidates(vtkMRMLInteractionEventData* eventData, const vtkMRMLLayerDMPipelineI* polledPipeline);
+  void PollReentrantCandidatesConcurrently(vtkMRMLInteractionEventData* eventData);
+  static bool GetPickRay(vtkMRMLInteractionEventData* eventData, double start[3], double end[3]);
+  bool PollActiveFocusedPipeline(vtkMRMLInteractionEventData* eventData, const vtkMRMLLayerDMPipelineI*& polledPipeline);
+  std::tuple<double, int> PrioritizeCanProcessPipelines(vtkMRMLInteractionEventData* eventData, const vtkMRMLLayerDMPipelineI* polledPipeline);
   void LosePreviousFocusInCannotProcess(vtkMRMLInteractionEventData* eventData);
+  void UpdateBoundingVolumeHierarchies();
+  void CollectInteractionCandidates(vtkMRMLInteractionEventData* eventData);
+
+  /// Pipeline able to process the current event and its priority (widget state, render order, inverted distance)
+  struct Candidate
+  {
+    vtkMRMLLayerDMPipelineI* Pipeline;
+    std::tuple<int, unsigned int, double> Priority;
+  };
+
+  /// Poll result of an interaction candidate
+  struct PollResult
+  {
+    bool CanProcess;
+    double Distance2;
+  };
+
+  /// Bounds space and hierarchy item of the pipelines with interaction bounds
+  struct BoundedPipeline
+  {
+    int Space;
+    int Item;
+  };
 
   std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineI>> m_pipelines;
   vtkSmartPointer<vtkMRMLLayerDMPipelineI> m_prevFocusedPipeline;
-  std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineI>> m_canProcess;
+  std::vector<Candidate> m_canProcess;
   vtkWeakPointer<vtkMRMLAbstractViewNode> m_viewNode;
+
+  // Interaction candidates are stored as indices in m_pipelines
+  layer_dm::BoundingVolumeHierarchy<3> m_worldHierarchy;
+  layer_dm::BoundingVolumeHierarchy<2> m_displayHierarchy;
+  std::vector<int> m_worldBoundedPipelines;
+  std::vector<int> m_displayBoundedPipelines;
+  std::vector<int> m_unboundedPipelines;
+  std::vector<int> m_customCameraWorldPipelines;
+  std::vector<bool> m_isWorldItemCustomCamera;
+  std::unordered_map<const vtkMRMLLayerDMPipelineI*, BoundedPipeline> m_boundedPipelines;
+  std::vector<int> m_candidates;
+  bool m_isHierarchyOutdated;
+  int m_nPolledPipelines;
+
+  vtkSmartPointer<vtkMRMLInteractionEventData> m_coalescedMouseMove;
+  bool m_isMouseMoveCoalescingEnabled;
+  bool m_isRenderPending;
+  bool m_isCoalescingCurrentEvent;
+  bool m_wasLastMouseMoveProcessed;
+  double m_lastMouseMoveDistance2;
+  int m_nDroppedMouseMoves;
+
+  // Poll results are stored at the index of their candidate in m_candidates
+  std::vector<PollResult> m_pollResults;
+  std::vector<int> m_reentrantCandidates;
+  int m_concurrentPollingThreshold;
+  int m_nPollingThreads;
+  int m_nConcurrentlyPolledPipelines;
+
+  // Declared last to be stopped first on delete
+  std::unique_ptr<layer_dm::WorkStealingThreadPool> m_pollingPool;
 };
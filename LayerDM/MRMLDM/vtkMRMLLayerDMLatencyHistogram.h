@@ -0,0 +1,123 @@
+#pragma once
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace layer_dm
+{
+/// \brief Fixed size latency histogram with bounded relative error (HDR histogram like).
+///
+/// Latencies are recorded in microseconds. Values below 2^SubBucketBits are counted exactly, larger values are counted
+/// in logarithmic buckets each split in linear sub-buckets, which bounds the relative error of the reported percentiles
+/// to 1 / 2^SubBucketBits. Recording a value is constant time and doesn't allocate.
+class LatencyHistogram
+{
+public:
+  /// Number of bits of the linear sub-buckets
+  static constexpr int SubBucketBits = 5;
+
+  /// Values larger than the maximum (~12 days) are counted in the last bucket
+  static constexpr int MaxExponent = 40;
+
+  void RecordValue(double seconds)
+  {
+    const double microseconds = std::max(0.0, seconds * 1e6);
+    const auto value = microseconds >= static_cast<double>(MaxValue) ? MaxValue : static_cast<std::uint64_t>(microseconds);
+    this->m_counts[IndexOf(value)]++;
+    this->m_totalCount++;
+  }
+
+  /// Add the counts of the input histogram
+  void Merge(const LatencyHistogram& other)
+  {
+    for (std::size_t iCount = 0; iCount < this->m_counts.size(); ++iCount)
+    {
+      this->m_counts[iCount] += other.m_counts[iCount];
+    }
+    this->m_totalCount += other.m_totalCount;
+  }
+
+  /// Returns the latency in seconds below which the input percentile (in [0, 100]) of the values fall.
+  /// The returned value is the middle of the bucket containing the percentile. Returns 0 if the histogram is empty.
+  double GetValueAtPercentile(double percentile) const
+  {
+    if (this->m_totalCount == 0)
+    {
+      return 0;
+    }
+
+    const double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(this->m_totalCount);
+    const auto targetCount = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(rank + 0.5));
+    std::uint64_t count = 0;
+    for (int index = 0; index < NumberOfCounts; ++index)
+    {
+      count += this->m_counts[index];
+      if (count >= targetCount)
+      {
+        return 0.5 * (LowestValueAt(index) + HighestValueAt(index)) * 1e-6;
+      }
+    }
+    return static_cast<double>(MaxValue) * 1e-6;
+  }
+
+  std::uint64_t GetTotalCount() const { return this->m_totalCount; }
+
+  void Reset()
+  {
+    this->m_counts.fill(0);
+    this->m_totalCount = 0;
+  }
+
+private:
+  static constexpr int SubBucketCount = 1 << SubBucketBits;
+  static constexpr int SubBucketHalfCount = SubBucketCount / 2;
+  static constexpr int NumberOfCounts = SubBucketCount + (MaxExponent - SubBucketBits + 1) * SubBucketHalfCount;
+  static constexpr std::uint64_t MaxValue = (std::uint64_t{ 1 } << MaxExponent) - 1;
+
+  /// Values below SubBucketCount have their own index. Larger values are indexed by their exponent (shift keeping
+  /// SubBucketBits significant bits) and their remaining significant bits.
+  static int IndexOf(std::uint64_t value)
+  {
+    if (value < SubBucketCount)
+    {
+      return static_cast<int>(value);
+    }
+
+    int shift = 0;
+    while ((value >> shift) >= SubBucketCount)
+    {
+      ++shift;
+    }
+    const auto subBucket = static_cast<int>(value >> shift);
+    return SubBucketCount + (shift - 1) * SubBucketHalfCount + (subBucket - SubBucketHalfCount);
+  }
+
+  static double LowestValueAt(int index)
+  {
+    if (index < SubBucketCount)
+    {
+      return index;
+    }
+
+    const int shift = (index - SubBucketCount) / SubBucketHalfCount + 1;
+    const int subBucket = (index - SubBucketCount) % SubBucketHalfCount + SubBucketHalfCount;
+    return static_cast<double>(std::uint64_t(subBucket) << shift);
+  }
+
+  static double HighestValueAt(int index)
+  {
+    if (index < SubBucketCount)
+    {
+      return index;
+    }
+
+    const int shift = (index - SubBucketCount) / SubBucketHalfCount + 1;
+    return LowestValueAt(index) + static_cast<double>((std::uint64_t{ 1 } << shift) - 1);
+  }
+
+  std::array<std::uint64_t, NumberOfCounts> m_counts{};
+  std::uint64_t m_totalCount{ 0 };
+};
+} // namespace layer_dm
@@ -1,16 +1,25 @@
 #include "vtkMRMLLayerDMLayerManager.h"
 
 // Layer DM includes
+#include "vtkMRMLLayerDMCachedRenderPass.h"
 #include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMTracer.h"
 
 // VTK includes
 #include <vtkBoundingBox.h>
 #include <vtkCamera.h>
+#include <vtkMath.h>
 #include <vtkObjectFactory.h>
+#include <vtkPropCollection.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 #include <vtkRendererCollection.h>
 
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 vtkStandardNewMacro(vtkMRMLLayerDMLayerManager);
 
 void vtkMRMLLayerDMLayerManager::AddPipeline(vtkMRMLLayerDMPipelineI* pipeline)
@@ -21,12 +30,38 @@ void vtkMRMLLayerDMLayerManager::AddPipeline(vtkMRMLLayerDMPipelineI* pipeline)
   }
 
   auto key = this->GetPipelineLayerKey(pipeline);
-  if (!this->ContainsLayerKey(key))
+  const auto [storedKey, isNewPipeline] = this->m_pipelineKeys.try_emplace(pipeline, key);
+  if (!isNewPipeline && storedKey->second != key)
   {
-    this->m_pipelineLayers[key] = {};
+    this->UpdatePipelineLayer(pipeline);
+    return;
+  }
+
+  const int layerIndex = this->GetKeyIndex(key);
+  if (!this->CanAddToLayerIncrementally(layerIndex, pipeline))
+  {
+    this->GetOrCreateLayer(key).Insert(pipeline);
+    this->UpdateLayers();
+    return;
+  }
+
+  // Adding to an existing layer only requires setting the layer's renderer to the added pipeline
+  auto& layer = this->m_layers[layerIndex];
+  if (layer.Insert(pipeline))
+  {
+    pipeline->SetRenderer(layer.Renderer);
   }
-  this->m_pipelineLayers[key].emplace(pipeline);
-  this->UpdateLayers();
+}
+
+bool vtkMRMLLayerDMLayerManager::BlockUpdateLayers(bool isBlocked)
+{
+  const auto wasBlocked = this->m_isUpdateLayersBlocked;
+  this->m_isUpdateLayersBlocked = isBlocked;
+  if (wasBlocked && !isBlocked && this->m_isUpdateLayersRequested)
+  {
+    this->UpdateLayers();
+  }
+  return wasBlocked;
 }
 
 vtkMRMLLayerDMLayerManager::LayerKey vtkMRMLLayerDMLayerManager::GetPipelineLayerKey(vtkMRMLLayerDMPipelineI* pipeline)
@@ -40,7 +75,7 @@ vtkMRMLLayerDMLayerManager::LayerKey vtkMRMLLayerDMLayerManager::GetPipelineLaye
 
 int vtkMRMLLayerDMLayerManager::GetNumberOfDistinctLayers() const
 {
-  return static_cast<int>(this->m_pipelineLayers.size());
+  return static_cast<int>(this->m_layers.size());
 }
 
 int vtkMRMLLayerDMLayerManager::GetNumberOfManagedLayers() const
@@ -53,6 +88,183 @@ int vtkMRMLLayerDMLayerManager::GetNumberOfRenderers() const
   return static_cast<int>(this->m_renderers.size());
 }
 
+void vtkMRMLLayerDMLayerManager::SetMaximumNumberOfRenderers(int maximumNumberOfRenderers)
+{
+  maximumNumberOfRenderers = std::max(0, maximumNumberOfRenderers);
+  if (this->m_maximumNumberOfRenderers == maximumNumberOfRenderers)
+  {
+    return;
+  }
+
+  this->m_maximumNumberOfRenderers = maximumNumberOfRenderers;
+  this->Modified();
+  this->UpdateLayers();
+}
+
+int vtkMRMLLayerDMLayerManager::GetMaximumNumberOfRenderers() const
+{
+  return this->m_maximumNumberOfRenderers;
+}
+
+unsigned int vtkMRMLLayerDMLayerManager::GetLayerRenderOrder(int layerIndex) const
+{
+  if (layerIndex < 0 || layerIndex >= this->GetNumberOfDistinctLayers())
+  {
+    return 0;
+  }
+  return std::get<0>(this->m_layers[layerIndex].Key);
+}
+
+vtkCamera* vtkMRMLLayerDMLayerManager::GetLayerCamera(int layerIndex) const
+{
+  if (layerIndex < 0 || layerIndex >= this->GetNumberOfDistinctLayers())
+  {
+    return nullptr;
+  }
+  return this->GetCameraForLayer(this->m_layers[layerIndex]);
+}
+
+int vtkMRMLLayerDMLayerManager::GetLayerRendererLayer(int layerIndex) const
+{
+  if (layerIndex < 0 || layerIndex >= this->GetNumberOfDistinctLayers())
+  {
+    return -1;
+  }
+  return this->m_layers[layerIndex].RendererSlot;
+}
+
+vtkRenderer* vtkMRMLLayerDMLayerManager::GetLayerRenderer(int layerIndex) const
+{
+  if (layerIndex < 0 || layerIndex >= this->GetNumberOfDistinctLayers())
+  {
+    return nullptr;
+  }
+  return this->m_layers[layerIndex].Renderer;
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfMergedLayers() const
+{
+  int nMerged = 0;
+  for (int iLayer = 2; iLayer < this->GetNumberOfDistinctLayers(); iLayer++)
+  {
+    if (this->m_layers[iLayer].RendererSlot == this->m_layers[iLayer - 1].RendererSlot)
+    {
+      nMerged++;
+    }
+  }
+  return nMerged;
+}
+
+void vtkMRMLLayerDMLayerManager::SetRendererPoolSize(int poolSize)
+{
+  poolSize = std::max(0, poolSize);
+  if (this->m_rendererPoolSize == poolSize)
+  {
+    return;
+  }
+
+  this->m_rendererPoolSize = poolSize;
+  if (static_cast<int>(this->m_rendererPool.size()) > poolSize)
+  {
+    this->m_rendererPool.resize(poolSize);
+  }
+  this->Modified();
+}
+
+int vtkMRMLLayerDMLayerManager::GetRendererPoolSize() const
+{
+  return this->m_rendererPoolSize;
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfPooledRenderers() const
+{
+  return static_cast<int>(this->m_rendererPool.size());
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfRendererPoolHits() const
+{
+  return this->m_nRendererPoolHits;
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfRendererPoolMisses() const
+{
+  return this->m_nRendererPoolMisses;
+}
+
+void vtkMRMLLayerDMLayerManager::ResetRendererPoolStatistics()
+{
+  this->m_nRendererPoolHits = 0;
+  this->m_nRendererPoolMisses = 0;
+}
+
+void vtkMRMLLayerDMLayerManager::SetRenderOrderCached(unsigned int renderOrder, bool isCached)
+{
+  if (this->IsRenderOrderCached(renderOrder) == isCached)
+  {
+    return;
+  }
+
+  if (isCached)
+  {
+    this->m_cachedRenderOrders.insert(renderOrder);
+  }
+  else
+  {
+    this->m_cachedRenderOrders.erase(renderOrder);
+  }
+  this->Modified();
+  this->UpdateLayers();
+}
+
+bool vtkMRMLLayerDMLayerManager::IsRenderOrderCached(unsigned int renderOrder) const
+{
+  return this->m_cachedRenderOrders.count(renderOrder) > 0;
+}
+
+vtkMRMLLayerDMCachedRenderPass* vtkMRMLLayerDMLayerManager::GetLayerCachePass(int layerIndex) const
+{
+  auto renderer = this->GetLayerRenderer(layerIndex);
+  return renderer ? vtkMRMLLayerDMCachedRenderPass::SafeDownCast(renderer->GetPass()) : nullptr;
+}
+
+void vtkMRMLLayerDMLayerManager::SetSkipEmptyLayersDraw(bool isEnabled)
+{
+  if (this->m_isSkipEmptyLayersDraw == isEnabled)
+  {
+    return;
+  }
+
+  this->m_isSkipEmptyLayersDraw = isEnabled;
+  this->UpdateRendererDrawStates();
+  this->Modified();
+}
+
+bool vtkMRMLLayerDMLayerManager::IsSkipEmptyLayersDrawEnabled() const
+{
+  return this->m_isSkipEmptyLayersDraw;
+}
+
+void vtkMRMLLayerDMLayerManager::UpdateRendererDrawStates()
+{
+  this->m_nSkippedLayerDraws = 0;
+  for (const auto& renderer : this->m_renderers)
+  {
+    // Render passes may draw without any prop (for instance post-processing passes) and are always drawn
+    const bool hasCustomPass = renderer->GetPass() && !vtkMRMLLayerDMCachedRenderPass::SafeDownCast(renderer->GetPass());
+    const bool isDrawn = !this->m_isSkipEmptyLayersDraw || hasCustomPass || renderer->VisibleActorCount() > 0;
+    renderer->SetDraw(isDrawn);
+    if (!isDrawn)
+    {
+      this->m_nSkippedLayerDraws++;
+    }
+  }
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfSkippedLayerDraws() const
+{
+  return this->m_nSkippedLayerDraws;
+}
+
 void vtkMRMLLayerDMLayerManager::RemovePipeline(vtkMRMLLayerDMPipelineI* pipeline)
 {
   if (!pipeline)
@@ -60,8 +272,16 @@ void vtkMRMLLayerDMLayerManager::RemovePipeline(vtkMRMLLayerDMPipelineI* pipelin
     return;
   }
 
-  auto key = this->GetPipelineLayerKey(pipeline);
-  if (!this->ContainsLayerKey(key))
+  // Use the stored key as the pipeline layer key may have changed since it was added
+  LayerKey key = this->GetPipelineLayerKey(pipeline);
+  if (const auto it = this->m_pipelineKeys.find(pipeline); it != this->m_pipelineKeys.end())
+  {
+    key = it->second;
+    this->m_pipelineKeys.erase(it);
+  }
+
+  const int layerIndex = this->GetKeyIndex(key);
+  if (layerIndex < 0)
   {
     return;
   }
@@ -69,24 +289,146 @@ void vtkMRMLLayerDMLayerManager::RemovePipeline(vtkMRMLLayerDMPipelineI* pipelin
   // Remove pipeline from its renderer
   this->RemovePipelineRenderer(pipeline);
 
+  // Removing from a layer which still contains pipelines doesn't affect the other layers
+  auto& layer = this->m_layers[layerIndex];
+  layer.Erase(pipeline);
+  if (this->AreLayersUpToDate() && layer.GetFirstPipeline())
+  {
+    return;
+  }
+
   // Update the other pipeline layers if needed
-  this->m_pipelineLayers[key].erase(pipeline);
+  this->UpdateLayers();
+}
+
+void vtkMRMLLayerDMLayerManager::UpdatePipelineLayer(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  const auto it = this->m_pipelineKeys.find(pipeline);
+  if (!pipeline || it == this->m_pipelineKeys.end())
+  {
+    return;
+  }
+
+  const auto key = this->GetPipelineLayerKey(pipeline);
+  const auto previousKey = it->second;
+  if (key == previousKey)
+  {
+    return;
+  }
+  it->second = key;
+
+  // Remove the pipeline from its previous layer without detaching it from its renderer
+  bool isPreviousLayerUsed = false;
+  if (const int previousIndex = this->GetKeyIndex(previousKey); previousIndex >= 0)
+  {
+    auto& previousLayer = this->m_layers[previousIndex];
+    previousLayer.Erase(pipeline);
+    isPreviousLayerUsed = previousLayer.GetFirstPipeline() != nullptr;
+  }
+
+  // Moving between existing layers only requires switching the moved pipeline renderer
+  const int layerIndex = this->GetKeyIndex(key);
+  if (isPreviousLayerUsed && this->CanAddToLayerIncrementally(layerIndex, pipeline))
+  {
+    auto& layer = this->m_layers[layerIndex];
+    layer.Insert(pipeline);
+    pipeline->SetRenderer(layer.Renderer);
+    return;
+  }
+
+  this->GetOrCreateLayer(key).Insert(pipeline);
   this->UpdateLayers();
 }
 
 void vtkMRMLLayerDMLayerManager::ResetCameraClippingRange() const
 {
   // Reset first renderer clipping range
+  // Same as vtkRenderer::ResetCameraClippingRange() using the cached bounds
   if (const auto defaultRenderer = this->GetDefaultRenderer())
   {
-    defaultRenderer->ResetCameraClippingRange();
+    if (this->m_defaultRendererBounds.Renderer != defaultRenderer)
+    {
+      this->m_defaultRendererBounds = RendererBounds{ defaultRenderer };
+    }
+    this->UpdateRendererBounds(this->m_defaultRendererBounds);
+    if (vtkMath::AreBoundsInitialized(this->m_defaultRendererBounds.Bounds.data()))
+    {
+      defaultRenderer->ResetCameraClippingRange(this->m_defaultRendererBounds.Bounds.data());
+    }
   }
 
   // Reset the managed renderers grouped by common cameras
-  for (const auto& pair : m_cameraRendererMap)
+  for (auto& [camera, group] : this->m_cameraRendererMap)
+  {
+    if (this->m_clippingRangeMode == SlabClippingRange && camera && camera == this->m_defaultCamera)
+    {
+      this->ResetSlabClippingRange(camera);
+      continue;
+    }
+
+    bool isModified = !group.IsBoundsValid;
+    for (auto& rendererBounds : group.Renderers)
+    {
+      isModified |= this->UpdateRendererBounds(rendererBounds);
+    }
+
+    if (isModified)
+    {
+      vtkBoundingBox bbox;
+      for (const auto& rendererBounds : group.Renderers)
+      {
+        if (rendererBounds.Renderer)
+        {
+          bbox.AddBounds(rendererBounds.Bounds.data());
+        }
+      }
+      bbox.GetBounds(group.Bounds.data());
+      group.IsBoundsValid = true;
+    }
+
+    for (const auto& rendererBounds : group.Renderers)
+    {
+      if (rendererBounds.Renderer)
+      {
+        rendererBounds.Renderer->ResetCameraClippingRange(group.Bounds.data());
+      }
+    }
+  }
+}
+
+int vtkMRMLLayerDMLayerManager::GetNumberOfBoundsComputations() const
+{
+  return this->m_nBoundsComputations;
+}
+
+void vtkMRMLLayerDMLayerManager::SetClippingRangeMode(ClippingRangeMode mode)
+{
+  if (this->m_clippingRangeMode == mode)
   {
-    this->ResetRenderersCameraClippingRange(pair.second, this->ComputeRenderersVisibleBounds(pair.second));
+    return;
   }
+  this->m_clippingRangeMode = mode;
+  this->Modified();
+}
+
+vtkMRMLLayerDMLayerManager::ClippingRangeMode vtkMRMLLayerDMLayerManager::GetClippingRangeMode() const
+{
+  return this->m_clippingRangeMode;
+}
+
+void vtkMRMLLayerDMLayerManager::SetSlabThickness(double thickness)
+{
+  if (this->m_slabThickness == thickness)
+  {
+    return;
+  }
+  this->m_slabThickness = thickness;
+  this->Modified();
+}
+
+double vtkMRMLLayerDMLayerManager::GetSlabThickness() const
+{
+  return this->m_slabThickness;
 }
 
 void vtkMRMLLayerDMLayerManager::SetRenderWindow(vtkRenderWindow* renderWindow)
@@ -118,17 +460,16 @@ vtkMRMLLayerDMLayerManager::vtkMRMLLayerDMLayerManager()
   this->AddPipeline(this->m_emptyPipeline);
 }
 
-vtkRenderer* vtkMRMLLayerDMLayerManager::GetRendererMatchingKey(const LayerKey& key)
+vtkRenderer* vtkMRMLLayerDMLayerManager::GetRendererForSlot(int rendererSlot) const
 {
-  // If key index matches the default layer, return the render window's first renderer
-  int keyIndex = this->GetKeyIndex(key);
-  if (keyIndex == 0)
+  // If slot matches the default layer, return the render window's first renderer
+  if (rendererSlot == 0)
   {
     return this->GetDefaultRenderer();
   }
 
-  // Otherwise, convert key index to matching managed renderer index and return the associated renderer
-  int rendererIndex = keyIndex - 1;
+  // Otherwise, convert slot to matching managed renderer index and return the associated renderer
+  int rendererIndex = rendererSlot - 1;
   if (rendererIndex < 0 || rendererIndex >= this->GetNumberOfRenderers())
   {
     return nullptr;
@@ -136,6 +477,98 @@ vtkRenderer* vtkMRMLLayerDMLayerManager::GetRendererMatchingKey(const LayerKey&
   return this->m_renderers[rendererIndex];
 }
 
+bool vtkMRMLLayerDMLayerManager::AreLayersUpToDate() const
+{
+  return this->m_renderWindow && !this->m_isUpdateLayersBlocked && !this->m_isUpdateLayersRequested;
+}
+
+bool vtkMRMLLayerDMLayerManager::CanAddToLayerIncrementally(int layerIndex, vtkMRMLLayerDMPipelineI* pipeline) const
+{
+  // New layer keys require reshuffling the renderers.
+  // Pipelines of merged layers also need to be reattached in order if their props would end up above the props of upper layers.
+  if (layerIndex < 0 || !this->AreLayersUpToDate() || !this->m_layers[layerIndex].Renderer)
+  {
+    return false;
+  }
+  return !this->IsMergedLayer(layerIndex) || (this->IsLastLayerOfRenderer(layerIndex) && !pipeline->UsesCustomRenderPass());
+}
+
+bool vtkMRMLLayerDMLayerManager::CanMergeLayers(const Layer& lower, const Layer& upper) const
+{
+  return std::get<1>(lower.Key) == std::get<1>(upper.Key) && !lower.UsesCustomRenderPass() && !upper.UsesCustomRenderPass() &&
+         this->IsRenderOrderCached(std::get<0>(lower.Key)) == this->IsRenderOrderCached(std::get<0>(upper.Key));
+}
+
+bool vtkMRMLLayerDMLayerManager::Layer::Insert(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  const auto it = this->SlotIndices.find(pipeline);
+  if (it != this->SlotIndices.end())
+  {
+    // Slot of a deleted pipeline may be reused by a new pipeline allocated at the same address
+    auto& slot = this->Pipelines[it->second];
+    if (slot.Pipeline)
+    {
+      return false;
+    }
+    slot.Pipeline = pipeline;
+    return true;
+  }
+
+  this->SlotIndices.emplace(pipeline, this->Pipelines.size());
+  this->Pipelines.push_back({ pipeline, pipeline });
+  return true;
+}
+
+bool vtkMRMLLayerDMLayerManager::Layer::Erase(const vtkMRMLLayerDMPipelineI* pipeline)
+{
+  const auto it = this->SlotIndices.find(pipeline);
+  if (it == this->SlotIndices.end())
+  {
+    return false;
+  }
+  this->EraseSlot(it->second);
+  return true;
+}
+
+void vtkMRMLLayerDMLayerManager::Layer::EraseDeletedPipelines()
+{
+  for (std::size_t iSlot = this->Pipelines.size(); iSlot > 0; --iSlot)
+  {
+    if (!this->Pipelines[iSlot - 1].Pipeline)
+    {
+      this->EraseSlot(iSlot - 1);
+    }
+  }
+}
+
+vtkMRMLLayerDMPipelineI* vtkMRMLLayerDMLayerManager::Layer::GetFirstPipeline() const
+{
+  for (const auto& slot : this->Pipelines)
+  {
+    if (slot.Pipeline)
+    {
+      return slot.Pipeline;
+    }
+  }
+  return nullptr;
+}
+
+bool vtkMRMLLayerDMLayerManager::Layer::UsesCustomRenderPass() const
+{
+  return std::any_of(this->Pipelines.begin(), this->Pipelines.end(), [](const PipelineSlot& slot) { return slot.Pipeline && slot.Pipeline->UsesCustomRenderPass(); });
+}
+
+void vtkMRMLLayerDMLayerManager::Layer::EraseSlot(std::size_t iSlot)
+{
+  this->SlotIndices.erase(this->Pipelines[iSlot].Key);
+  if (iSlot + 1 != this->Pipelines.size())
+  {
+    this->Pipelines[iSlot] = std::move(this->Pipelines.back());
+    this->SlotIndices[this->Pipelines[iSlot].Key] = iSlot;
+  }
+  this->Pipelines.pop_back();
+}
+
 vtkRenderer* vtkMRMLLayerDMLayerManager::GetDefaultRenderer() const
 {
   if (!this->m_renderWindow)
@@ -145,40 +578,73 @@ vtkRenderer* vtkMRMLLayerDMLayerManager::GetDefaultRenderer() const
   return this->m_renderWindow->GetRenderers()->GetFirstRenderer();
 }
 
+vtkSmartPointer<vtkRenderer> vtkMRMLLayerDMLayerManager::AcquireRenderer()
+{
+  if (!this->m_rendererPool.empty())
+  {
+    auto renderer = this->m_rendererPool.back();
+    this->m_rendererPool.pop_back();
+    renderer->DrawOn();
+    this->m_nRendererPoolHits++;
+    return renderer;
+  }
+
+  // Managed renderers are displayed as overlays and should not catch any events.
+  // Events handling is done using the DM mechanism.
+  auto renderer = vtkSmartPointer<vtkRenderer>::New();
+  renderer->InteractiveOff();
+  this->m_nRendererPoolMisses++;
+  return renderer;
+}
+
 void vtkMRMLLayerDMLayerManager::AddMissingLayers()
 {
-  while (this->GetNumberOfRenderers() < this->GetNumberOfManagedLayers())
+  while (this->GetNumberOfRenderers() < this->m_nRequiredRenderers)
   {
-    // Managed renderers are displayed as overlays and should not catch any events.
-    // Events handling is done using the DM mechanism.
-    auto renderer = vtkSmartPointer<vtkRenderer>::New();
-    renderer->InteractiveOff();
+    auto renderer = this->AcquireRenderer();
     this->m_renderWindow->AddRenderer(renderer);
     this->m_renderers.emplace_back(renderer);
   }
 }
 
-std::array<double, 6> vtkMRMLLayerDMLayerManager::ComputeRenderersVisibleBounds(const std::set<vtkWeakPointer<vtkRenderer>>& renderers)
+bool vtkMRMLLayerDMLayerManager::ContainsLayerKey(const LayerKey& key) const
 {
-  vtkBoundingBox bbox;
+  return this->GetKeyIndex(key) >= 0;
+}
 
-  for (const auto& renderer : renderers)
+void vtkMRMLLayerDMLayerManager::DetachMergedLayerPipelines()
+{
+  // Pipelines add their props when attached to their renderer.
+  // Detach the pipelines of merged layers to reattach them in ascending layer order and keep their props ordered.
+  for (int iLayer = 0; iLayer < this->GetNumberOfDistinctLayers(); iLayer++)
   {
-    if (!renderer)
+    if (!this->IsMergedLayer(iLayer))
     {
       continue;
     }
-    bbox.AddBounds(renderer->ComputeVisiblePropBounds());
+
+    auto& layer = this->m_layers[iLayer];
+    layer.Renderer = nullptr;
+    for (const auto& slot : layer.Pipelines)
+    {
+      this->RemovePipelineRenderer(slot.Pipeline);
+    }
   }
+}
 
-  std::array<double, 6> bounds{};
-  bbox.GetBounds(bounds.data());
-  return bounds;
+bool vtkMRMLLayerDMLayerManager::IsLastLayerOfRenderer(int layerIndex) const
+{
+  return layerIndex + 1 >= this->GetNumberOfDistinctLayers() || this->m_layers[layerIndex + 1].RendererSlot != this->m_layers[layerIndex].RendererSlot;
 }
 
-bool vtkMRMLLayerDMLayerManager::ContainsLayerKey(const LayerKey& key)
+bool vtkMRMLLayerDMLayerManager::IsMergedLayer(int layerIndex) const
 {
-  return this->m_pipelineLayers.find(key) != this->m_pipelineLayers.end();
+  const int rendererSlot = this->m_layers[layerIndex].RendererSlot;
+  if (rendererSlot == 0)
+  {
+    return false;
+  }
+  return !this->IsLastLayerOfRenderer(layerIndex) || (layerIndex > 0 && this->m_layers[layerIndex - 1].RendererSlot == rendererSlot);
 }
 
 std::uintptr_t vtkMRMLLayerDMLayerManager::GetCameraId(vtkCamera* camera)
@@ -190,41 +656,43 @@ std::uintptr_t vtkMRMLLayerDMLayerManager::GetCameraId(vtkCamera* camera)
   return reinterpret_cast<std::uintptr_t>(camera);
 }
 
-vtkCamera* vtkMRMLLayerDMLayerManager::GetCameraForLayer(const LayerKey& key, const std::set<vtkWeakPointer<vtkMRMLLayerDMPipelineI>>& pipelines) const
+vtkCamera* vtkMRMLLayerDMLayerManager::GetCameraForLayer(const Layer& layer) const
 {
-  if (const auto cameraId = std::get<1>(key); cameraId == 0)
+  if (const auto cameraId = std::get<1>(layer.Key); cameraId == 0)
   {
     return this->m_defaultCamera;
   }
 
-  for (const auto& pipeline : pipelines)
+  const auto pipeline = layer.GetFirstPipeline();
+  return pipeline ? pipeline->GetCustomCamera() : nullptr;
+}
+
+int vtkMRMLLayerDMLayerManager::GetKeyIndex(const LayerKey& key) const
+{
+  const auto it = std::lower_bound(this->m_layers.begin(), this->m_layers.end(), key, [](const Layer& layer, const LayerKey& value) { return layer.Key < value; });
+  if (it == this->m_layers.end() || it->Key != key)
   {
-    if (pipeline)
-    {
-      return pipeline->GetCustomCamera();
-    }
+    return -1;
   }
-
-  return nullptr;
+  return static_cast<int>(std::distance(this->m_layers.begin(), it));
 }
 
-int vtkMRMLLayerDMLayerManager::GetKeyIndex(const LayerKey& key) const
+vtkMRMLLayerDMLayerManager::Layer& vtkMRMLLayerDMLayerManager::GetOrCreateLayer(const LayerKey& key)
 {
-  int index = 0;
-  for (const auto& pair : m_pipelineLayers)
+  auto it = std::lower_bound(this->m_layers.begin(), this->m_layers.end(), key, [](const Layer& layer, const LayerKey& value) { return layer.Key < value; });
+  if (it == this->m_layers.end() || it->Key != key)
   {
-    if (pair.first == key)
-    {
-      return index;
-    }
-    ++index;
+    it = this->m_layers.insert(it, Layer{});
+    it->Key = key;
   }
-  return -1;
+  return *it;
 }
 
 void vtkMRMLLayerDMLayerManager::RemoveAllLayers()
 {
-  for (const auto& renderer : m_renderers)
+  // Iterate on a copy as removal erases the renderers from the managed renderers
+  const auto renderers = this->m_renderers;
+  for (const auto& renderer : renderers)
   {
     this->RemoveRenderer(renderer);
   }
@@ -235,11 +703,12 @@ void vtkMRMLLayerDMLayerManager::RemoveAllLayers()
 void vtkMRMLLayerDMLayerManager::RemoveAllPipelineRenderers()
 {
   // if the render window is null, notify pipelines
-  for (const auto& [key, pipelines] : m_pipelineLayers)
+  for (auto& layer : this->m_layers)
   {
-    for (const auto& pipeline : pipelines)
+    layer.Renderer = nullptr;
+    for (const auto& slot : layer.Pipelines)
     {
-      this->RemovePipelineRenderer(pipeline);
+      this->RemovePipelineRenderer(slot.Pipeline);
     }
   }
 }
@@ -254,7 +723,7 @@ void vtkMRMLLayerDMLayerManager::RemovePipelineRenderer(vtkMRMLLayerDMPipelineI*
 
 void vtkMRMLLayerDMLayerManager::RemoveOutdatedLayers()
 {
-  while (this->GetNumberOfRenderers() && (this->GetNumberOfRenderers() > this->GetNumberOfManagedLayers()))
+  while (this->GetNumberOfRenderers() && (this->GetNumberOfRenderers() > this->m_nRequiredRenderers))
   {
     this->RemoveRenderer(this->m_renderers[this->GetNumberOfRenderers() - 1]);
   }
@@ -262,22 +731,36 @@ void vtkMRMLLayerDMLayerManager::RemoveOutdatedLayers()
 
 void vtkMRMLLayerDMLayerManager::RemoveOutdatedPipelines()
 {
-  // Remove pipelines which have been garbage collected
-  for (auto& [key, pipelines] : m_pipelineLayers)
+  // Remove pipelines which have been garbage collected and the layers left empty
+  // Stored keys are only removed if they were not reused by a new pipeline allocated at the same address
+  for (auto& layer : this->m_layers)
   {
-    for (const auto& pipeline : pipelines)
+    for (const auto& slot : layer.Pipelines)
     {
-      if (!pipeline)
+      const auto it = this->m_pipelineKeys.find(slot.Key);
+      if (!slot.Pipeline && it != this->m_pipelineKeys.end() && it->second == layer.Key)
       {
-        pipelines.erase(pipeline);
+        this->m_pipelineKeys.erase(it);
       }
     }
+    layer.EraseDeletedPipelines();
+  }
+  this->m_layers.erase(std::remove_if(this->m_layers.begin(), this->m_layers.end(), [](const Layer& layer) { return layer.Pipelines.empty(); }),
+                       this->m_layers.end());
+}
 
-    if (pipelines.empty())
-    {
-      this->m_pipelineLayers.erase(key);
-    }
+void vtkMRMLLayerDMLayerManager::ReleaseRenderer(const vtkSmartPointer<vtkRenderer>& renderer)
+{
+  if (static_cast<int>(this->m_rendererPool.size()) >= this->m_rendererPoolSize)
+  {
+    return;
   }
+
+  // Park the renderer without any state left by the pipelines of its previous layer
+  renderer->RemoveAllViewProps();
+  renderer->SetPass(nullptr);
+  renderer->DrawOff();
+  this->m_rendererPool.emplace_back(renderer);
 }
 
 void vtkMRMLLayerDMLayerManager::RemoveRenderer(const vtkSmartPointer<vtkRenderer>& renderer)
@@ -287,31 +770,64 @@ void vtkMRMLLayerDMLayerManager::RemoveRenderer(const vtkSmartPointer<vtkRendere
     this->m_renderWindow->RemoveRenderer(renderer);
   }
 
+  this->ReleaseRenderer(renderer);
   this->m_renderers.erase(std::find(this->m_renderers.begin(), this->m_renderers.end(), renderer));
 }
 
-void vtkMRMLLayerDMLayerManager::ResetRenderersCameraClippingRange(const std::set<vtkWeakPointer<vtkRenderer>>& renderers, const std::array<double, 6>& bounds)
+vtkMTimeType vtkMRMLLayerDMLayerManager::GetVisiblePropsMTime(vtkRenderer* renderer)
 {
-  for (const auto& renderer : renderers)
+  // Prop collection is modified when props are added / removed.
+  // Redraw MTime covers the prop (including visibility), its mapper and the mapper input modifications.
+  auto props = renderer->GetViewProps();
+  vtkMTimeType mTime = props->GetMTime();
+  props->InitTraversal();
+  while (auto prop = props->GetNextProp())
   {
-    if (!renderer)
-    {
-      continue;
-    }
-    renderer->ResetCameraClippingRange(const_cast<double*>(bounds.data()));
+    mTime = std::max(mTime, prop->GetRedrawMTime());
   }
+  return mTime;
+}
+
+void vtkMRMLLayerDMLayerManager::ResetSlabClippingRange(vtkCamera* camera) const
+{
+  // Focal point lies on the slab center plane, near / far planes are placed at half thickness on both sides
+  constexpr double minNear = 1e-3;
+  const double distance = camera->GetDistance();
+  const double halfThickness = 0.5 * std::abs(this->m_slabThickness);
+  camera->SetClippingRange(std::max(distance - halfThickness, minNear), std::max(distance + halfThickness, 2 * minNear));
+}
+
+bool vtkMRMLLayerDMLayerManager::UpdateRendererBounds(RendererBounds& rendererBounds) const
+{
+  if (!rendererBounds.Renderer)
+  {
+    return false;
+  }
+
+  const auto mTime = GetVisiblePropsMTime(rendererBounds.Renderer);
+  if (mTime == rendererBounds.PropsMTime)
+  {
+    return false;
+  }
+
+  rendererBounds.Renderer->ComputeVisiblePropBounds(rendererBounds.Bounds.data());
+  rendererBounds.PropsMTime = mTime;
+  this->m_nBoundsComputations++;
+  return true;
 }
 
 void vtkMRMLLayerDMLayerManager::SynchronizePipelineRenderers()
 {
-  for (const auto& pair : m_pipelineLayers)
+  this->DetachMergedLayerPipelines();
+  for (int iLayer = 0; iLayer < this->GetNumberOfDistinctLayers(); iLayer++)
   {
-    auto renderer = this->GetRendererMatchingKey(pair.first);
-    for (const auto& pipeline : pair.second)
+    auto& layer = this->m_layers[iLayer];
+    layer.Renderer = this->GetRendererForSlot(layer.RendererSlot);
+    for (const auto& slot : layer.Pipelines)
     {
-      if (pipeline)
+      if (slot.Pipeline)
       {
-        pipeline->SetRenderer(renderer);
+        slot.Pipeline->SetRenderer(layer.Renderer);
       }
     }
   }
@@ -340,6 +856,15 @@ void vtkMRMLLayerDMLayerManager::UpdateRenderWindowNumberOfLayers() const
 
 void vtkMRMLLayerDMLayerManager::UpdateLayers()
 {
+  // Defer the update until the layers are unblocked
+  if (this->m_isUpdateLayersBlocked)
+  {
+    this->m_isUpdateLayersRequested = true;
+    return;
+  }
+  this->m_isUpdateLayersRequested = false;
+
+  vtkMRMLLayerDMTracer::Scope traceScope{ "UpdateLayers", "layers" };
   if (!this->m_renderWindow)
   {
     this->RemoveAllPipelineRenderers();
@@ -347,14 +872,39 @@ void vtkMRMLLayerDMLayerManager::UpdateLayers()
   }
 
   this->RemoveOutdatedPipelines();
+  this->UpdateLayerRendererSlots();
   this->RemoveOutdatedLayers();
   this->AddMissingLayers();
   this->UpdateRendererLayerOrdering();
   this->UpdateRendererCamera();
   this->SynchronizePipelineRenderers();
+  this->UpdateRendererCachePasses();
   this->UpdateRenderWindowNumberOfLayers();
 }
 
+void vtkMRMLLayerDMLayerManager::UpdateLayerRendererSlots()
+{
+  // Default layer is always displayed in the default renderer and each managed layer gets its own renderer by default.
+  // If over budget, merge the managed layers into the renderer of their lower neighbor starting from the lowest layers.
+  int nRenderers = this->GetNumberOfManagedLayers();
+  int rendererSlot = 0;
+  for (int iLayer = 0; iLayer < this->GetNumberOfDistinctLayers(); iLayer++)
+  {
+    auto& layer = this->m_layers[iLayer];
+    const bool isOverBudget = this->m_maximumNumberOfRenderers > 0 && nRenderers > this->m_maximumNumberOfRenderers;
+    if (iLayer > 1 && isOverBudget && this->CanMergeLayers(this->m_layers[iLayer - 1], layer))
+    {
+      nRenderers--;
+    }
+    else if (iLayer > 0)
+    {
+      rendererSlot++;
+    }
+    layer.RendererSlot = rendererSlot;
+  }
+  this->m_nRequiredRenderers = rendererSlot;
+}
+
 void vtkMRMLLayerDMLayerManager::UpdateRendererLayerOrdering() const
 {
   // Managed layers are always ordered from layer 1 to the number of managed renderers
@@ -364,6 +914,32 @@ void vtkMRMLLayerDMLayerManager::UpdateRendererLayerOrdering() const
   }
 }
 
+void vtkMRMLLayerDMLayerManager::UpdateRendererCachePasses()
+{
+  // Merged layers share the same cache status, the cache pass is set from the first layer of each managed renderer.
+  // Render passes set by the pipelines are left unchanged.
+  for (int iLayer = 1; iLayer < this->GetNumberOfDistinctLayers(); iLayer++)
+  {
+    const auto& layer = this->m_layers[iLayer];
+    auto renderer = layer.Renderer;
+    if (!renderer || layer.RendererSlot == this->m_layers[iLayer - 1].RendererSlot)
+    {
+      continue;
+    }
+
+    const bool isCached = this->IsRenderOrderCached(std::get<0>(layer.Key)) && !layer.UsesCustomRenderPass();
+    const bool hasCachePass = vtkMRMLLayerDMCachedRenderPass::SafeDownCast(renderer->GetPass()) != nullptr;
+    if (isCached && !renderer->GetPass())
+    {
+      renderer->SetPass(vtkSmartPointer<vtkMRMLLayerDMCachedRenderPass>::New());
+    }
+    else if (!isCached && hasCachePass)
+    {
+      renderer->SetPass(nullptr);
+    }
+  }
+}
+
 void vtkMRMLLayerDMLayerManager::UpdateRendererCamera()
 {
   // Set the camera for the managed renderers
@@ -372,16 +948,17 @@ void vtkMRMLLayerDMLayerManager::UpdateRendererCamera()
   // Pipelines with custom camera are grouped and use their cameras
   this->m_cameraRendererMap.clear();
 
-  int iRenderer = -1;
-  for (const auto& pair : m_pipelineLayers)
+  // Merged layers share the same camera, the renderer camera is set from the first layer of each renderer
+  int previousSlot = 0;
+  for (const auto& layer : this->m_layers)
   {
-    if (iRenderer >= 0 && iRenderer < this->GetNumberOfRenderers())
+    const int iRenderer = layer.RendererSlot - 1;
+    if (layer.RendererSlot != previousSlot && iRenderer >= 0 && iRenderer < this->GetNumberOfRenderers())
     {
-      auto camera = this->GetCameraForLayer(pair.first, pair.second);
+      auto camera = this->GetCameraForLayer(layer);
       this->m_renderers[iRenderer]->SetActiveCamera(camera);
-      this->m_cameraRendererMap[camera].emplace(this->m_renderers[iRenderer]);
+      this->m_cameraRendererMap[camera].Renderers.push_back({ this->m_renderers[iRenderer] });
     }
-
-    iRenderer++;
+    previousSlot = layer.RendererSlot;
   }
 }
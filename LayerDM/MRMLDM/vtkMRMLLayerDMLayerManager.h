@@ -11,11 +11,15 @@
 
 // STL includes
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <set>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+class vtkMRMLLayerDMCachedRenderPass;
 class vtkMRMLLayerDMPipelineI;
 class vtkRenderWindow;
 class vtkRenderer;
@@ -31,20 +35,44 @@ class vtkCamera;
 ///
 /// When pipelines are added / removed, renderers are created or deleted, and renderer layers are optimized
 /// depending on the pipelines' preferred render order number.
-/// Order number is read-only during update and is expected to be static per pipeline.
+/// Adding / removing a pipeline to / from an existing layer is incremental and only notifies the added / removed
+/// pipeline. Only the creation or deletion of a layer updates the renderers of the other pipelines.
+/// The layer key of each pipeline is stored when the pipeline is added. Render order and custom camera changes are
+/// expected to be notified using \sa UpdatePipelineLayer which moves the pipeline from its stored layer to its new layer.
+///
+/// Each managed renderer costs a full render pass. When the number of managed layers exceeds the maximum number of
+/// renderers, adjacent layers sharing the same camera and without any custom render pass pipeline are merged into the same
+/// renderer. Pipelines of merged layers are attached in ascending layer order so that their props are ordered by render
+/// order in the shared renderer. \sa SetMaximumNumberOfRenderers
 class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMLayerManager : public vtkObject
 {
 public:
   using LayerKey = std::tuple<unsigned int, std::uintptr_t>;
 
+  enum ClippingRangeMode
+  {
+    // Clipping range is computed from the visible prop bounds of the renderers sharing the same camera
+    VisiblePropBoundsClippingRange = 0,
+    // Clipping range of the default camera layers is a slab centered on the default camera focal plane.
+    // Other layers use the visible prop bounds.
+    SlabClippingRange
+  };
+
   static vtkMRMLLayerDMLayerManager* New();
   vtkTypeMacro(vtkMRMLLayerDMLayerManager, vtkObject);
 
   /// Adds the pipeline to the layers.
-  /// May change an update of the layer ordering.
+  /// May change an update of the layer ordering if the pipeline's layer doesn't exist yet.
   /// Will trigger the SetRenderer call on the pipeline when it's added to its layer.
   void AddPipeline(vtkMRMLLayerDMPipelineI* pipeline);
 
+  /// Block the layer update triggered by pipeline addition / removal.
+  /// When unblocked, the layers are updated once if any update was requested while blocked.
+  /// Returns the previous blocked value.
+  ///
+  /// Allows to add / remove multiple pipelines with a single layer update (for instance during scene batch processing).
+  bool BlockUpdateLayers(bool isBlocked);
+
   static LayerKey GetPipelineLayerKey(vtkMRMLLayerDMPipelineI* pipeline);
 
   int GetNumberOfDistinctLayers() const;
@@ -53,13 +81,114 @@ public:
   /// Returns the current number of managed renderers in the render window.
   int GetNumberOfRenderers() const;
 
+  /// @{
+  /// Maximum number of managed renderers (default 0 = unlimited).
+  /// When the number of managed layers exceeds the maximum, adjacent layers are merged starting from the lowest render
+  /// orders. Layers with different cameras or with pipelines using a custom render pass are never merged, the number of
+  /// renderers may hence stay above the maximum. \sa vtkMRMLLayerDMPipelineI::SetUsesCustomRenderPass
+  void SetMaximumNumberOfRenderers(int maximumNumberOfRenderers);
+  int GetMaximumNumberOfRenderers() const;
+  /// @}
+
+  /// @{
+  /// Layer mapping query API.
+  /// Layers are indexed in ascending <render order, camera> order from 0 to \sa GetNumberOfDistinctLayers, layer 0 being
+  /// the default layer displayed in the render window first renderer.
+  unsigned int GetLayerRenderOrder(int layerIndex) const;
+  vtkCamera* GetLayerCamera(int layerIndex) const;
+  /// Returns the render window layer of the renderer displaying the layer (0 for the default renderer) or -1 if invalid.
+  int GetLayerRendererLayer(int layerIndex) const;
+  /// Returns the renderer displaying the layer or nullptr if invalid or if the render window is not set.
+  vtkRenderer* GetLayerRenderer(int layerIndex) const;
+  /// Returns the number of layers sharing their renderer with a lower layer.
+  int GetNumberOfMergedLayers() const;
+  /// @}
+
+  /// @{
+  /// Opt-in offscreen cache of the layers with the input render order (disabled by default).
+  /// The renderers of cached layers are rendered once in an offscreen image which is composited on the next frames as
+  /// long as their props, camera and size don't change. Cached layers are only merged with other cached layers.
+  /// Layers containing pipelines using a custom render pass are never cached.
+  /// \sa vtkMRMLLayerDMCachedRenderPass
+  void SetRenderOrderCached(unsigned int renderOrder, bool isCached);
+  bool IsRenderOrderCached(unsigned int renderOrder) const;
+  /// @}
+
+  /// Returns the cache render pass of the layer renderer or nullptr if the layer is not cached.
+  vtkMRMLLayerDMCachedRenderPass* GetLayerCachePass(int layerIndex) const;
+
+  /// @{
+  /// Maximum number of unused renderers kept for reuse when layers are deleted (default 4).
+  /// Parked renderers are detached from the render window, their props and render pass are removed and their drawing
+  /// is disabled. Reducing the size releases the renderers exceeding the new size.
+  void SetRendererPoolSize(int poolSize);
+  int GetRendererPoolSize() const;
+  /// @}
+
+  /// Returns the number of renderers currently parked in the renderer pool.
+  int GetNumberOfPooledRenderers() const;
+
+  /// @{
+  /// Renderer pool statistics. Hits count the layers created using a pooled renderer, misses the layers requiring a new
+  /// renderer.
+  int GetNumberOfRendererPoolHits() const;
+  int GetNumberOfRendererPoolMisses() const;
+  void ResetRendererPoolStatistics();
+  /// @}
+
+  /// @{
+  /// When enabled (default), the drawing of the managed renderers without any visible prop is disabled by
+  /// \sa UpdateRendererDrawStates, which avoids their render pass cost when all their pipelines are hidden.
+  /// Renderers with a render pass set are always drawn. Disabling the option re-enables the drawing of all renderers.
+  void SetSkipEmptyLayersDraw(bool isEnabled);
+  bool IsSkipEmptyLayersDrawEnabled() const;
+  /// @}
+
+  /// Enables the drawing of the managed renderers with visible props and disables it for the others.
+  /// Expected to be called before each render. \sa vtkMRMLLayerDMPipelineManager
+  void UpdateRendererDrawStates();
+
+  /// Returns the number of managed renderers whose drawing was skipped by the last \sa UpdateRendererDrawStates call.
+  int GetNumberOfSkippedLayerDraws() const;
+
   /// Removes the pipeline from the layers.
   /// May change the layer ordering if pipeline was the last one of its current renderer.
   void RemovePipeline(vtkMRMLLayerDMPipelineI* pipeline);
 
+  /// Moves the pipeline from its stored layer to the layer matching its current render order and custom camera.
+  /// The move is incremental and only notifies the moved pipeline if its previous layer still contains pipelines and
+  /// its new layer already exists. Otherwise, the layers are updated.
+  /// Does nothing if the pipeline was not added or if its layer key didn't change.
+  void UpdatePipelineLayer(vtkMRMLLayerDMPipelineI* pipeline);
+
   /// Iterates over the renderers and resets their clipping range to visible bounds
+  ///
+  /// Visible prop bounds are cached per renderer and only recomputed when a prop is added / removed or when the redraw
+  /// MTime of one of its props (prop, mapper or mapper input modification) has changed.
+  /// The bounds union of renderers sharing the same camera is only recomputed when one of the renderers' bounds changed.
   void ResetCameraClippingRange() const;
 
+  /// Returns the number of renderer visible prop bounds computed by \sa ResetCameraClippingRange.
+  int GetNumberOfBoundsComputations() const;
+
+  /// Returns the max of the renderer prop collection MTime and of its props redraw MTime.
+  /// Changes when a prop is added / removed or when a prop, its mapper or its mapper input is modified.
+  static vtkMTimeType GetVisiblePropsMTime(vtkRenderer* renderer);
+
+  /// @{
+  /// Clipping range computation mode used by \sa ResetCameraClippingRange (default VisiblePropBoundsClippingRange).
+  void SetClippingRangeMode(ClippingRangeMode mode);
+  ClippingRangeMode GetClippingRangeMode() const;
+  /// @}
+
+  /// @{
+  /// Thickness of the slab centered on the default camera focal plane in SlabClippingRange mode (default 1).
+  /// The near plane is clamped to a positive distance if the default camera is closer to its focal point than half the
+  /// slab thickness.
+  void SetSlabThickness(double thickness);
+  double GetSlabThickness() const;
+  /// @}
+
   /// Changes the render window managed by the layer manager.
   /// Will trigger a removal of all managed layers and creation of new layers if the render window is not null.
   void SetRenderWindow(vtkRenderWindow* renderWindow);
@@ -72,30 +201,88 @@ protected:
   ~vtkMRMLLayerDMLayerManager() override = default;
 
 private:
-  vtkRenderer* GetRendererMatchingKey(const LayerKey& key);
+  /// Pipeline slot of a layer. The key is kept to allow removing the slot once the pipeline has been deleted.
+  struct PipelineSlot
+  {
+    vtkMRMLLayerDMPipelineI* Key{ nullptr };
+    vtkWeakPointer<vtkMRMLLayerDMPipelineI> Pipeline;
+  };
+
+  /// Pipelines sharing the same layer key and the renderer they are currently set to.
+  /// Pipeline slots are indexed by pipeline pointer and swap removed.
+  struct Layer
+  {
+    LayerKey Key;
+    std::vector<PipelineSlot> Pipelines;
+    std::unordered_map<const vtkMRMLLayerDMPipelineI*, std::size_t> SlotIndices;
+    vtkWeakPointer<vtkRenderer> Renderer;
+    // Index of the layer renderer : 0 for the default renderer, i for the i-th managed renderer
+    int RendererSlot{ 0 };
+
+    bool Insert(vtkMRMLLayerDMPipelineI* pipeline);
+    bool Erase(const vtkMRMLLayerDMPipelineI* pipeline);
+    void EraseDeletedPipelines();
+    vtkMRMLLayerDMPipelineI* GetFirstPipeline() const;
+    bool UsesCustomRenderPass() const;
+
+  private:
+    void EraseSlot(std::size_t iSlot);
+  };
+
+  /// Visible prop bounds of a renderer and the props MTime they were computed at
+  struct RendererBounds
+  {
+    vtkWeakPointer<vtkRenderer> Renderer;
+    vtkMTimeType PropsMTime{ 0 };
+    std::array<double, 6> Bounds{};
+  };
+
+  /// Renderers sharing the same camera and the union of their bounds
+  struct CameraGroup
+  {
+    std::vector<RendererBounds> Renderers;
+    std::array<double, 6> Bounds{};
+    bool IsBoundsValid{ false };
+  };
+
+  bool AreLayersUpToDate() const;
+  bool CanAddToLayerIncrementally(int layerIndex, vtkMRMLLayerDMPipelineI* pipeline) const;
+  bool CanMergeLayers(const Layer& lower, const Layer& upper) const;
+  vtkRenderer* GetRendererForSlot(int rendererSlot) const;
   vtkRenderer* GetDefaultRenderer() const;
 
+  vtkSmartPointer<vtkRenderer> AcquireRenderer();
   void AddMissingLayers();
-  static std::array<double, 6> ComputeRenderersVisibleBounds(const std::set<vtkWeakPointer<vtkRenderer>>& renderers);
-  bool ContainsLayerKey(const LayerKey& key);
+  bool ContainsLayerKey(const LayerKey& key) const;
+  void DetachMergedLayerPipelines();
+  bool IsLastLayerOfRenderer(int layerIndex) const;
+  bool IsMergedLayer(int layerIndex) const;
   static std::uintptr_t GetCameraId(vtkCamera* camera);
-  vtkCamera* GetCameraForLayer(const LayerKey& key, const std::set<vtkWeakPointer<vtkMRMLLayerDMPipelineI>>& pipelines) const;
+  vtkCamera* GetCameraForLayer(const Layer& layer) const;
   int GetKeyIndex(const LayerKey& key) const;
+  Layer& GetOrCreateLayer(const LayerKey& key);
   void RemoveAllLayers();
   void RemoveAllPipelineRenderers();
   static void RemovePipelineRenderer(vtkMRMLLayerDMPipelineI* pipeline);
   void RemoveOutdatedLayers();
   void RemoveOutdatedPipelines();
+  void ReleaseRenderer(const vtkSmartPointer<vtkRenderer>& renderer);
   void RemoveRenderer(const vtkSmartPointer<vtkRenderer>& renderer);
-  static void ResetRenderersCameraClippingRange(const std::set<vtkWeakPointer<vtkRenderer>>& renderers, const std::array<double, 6>& bounds);
+  void ResetSlabClippingRange(vtkCamera* camera) const;
+  bool UpdateRendererBounds(RendererBounds& rendererBounds) const;
   void SynchronizePipelineRenderers();
   void UpdateRenderWindowNumberOfLayers() const;
   void UpdateLayers();
+  void UpdateLayerRendererSlots();
   void UpdateRendererLayerOrdering() const;
   void UpdateRendererCamera();
+  void UpdateRendererCachePasses();
 
-  // Map of pipeline layers ordered by ascending <layer value, camera synchronization mode>
-  std::map<LayerKey, std::set<vtkWeakPointer<vtkMRMLLayerDMPipelineI>>> m_pipelineLayers;
+  // Flat table of pipeline layers sorted by ascending <layer value, camera synchronization mode>
+  std::vector<Layer> m_layers;
+
+  // Layer key of the added pipelines when they were added or last moved
+  std::unordered_map<const vtkMRMLLayerDMPipelineI*, LayerKey> m_pipelineKeys;
 
   // Placeholder empty pipeline with target layer = 0 and camera sync to layer 0 for default renderer
   vtkSmartPointer<vtkMRMLLayerDMPipelineI> m_emptyPipeline;
@@ -109,6 +296,32 @@ private:
   // Renderers managed by the layer manager
   std::vector<vtkSmartPointer<vtkRenderer>> m_renderers;
 
-  // Camera to renderer map
-  std::map<vtkWeakPointer<vtkCamera>, std::set<vtkWeakPointer<vtkRenderer>>> m_cameraRendererMap;
+  // Renderer budget and number of managed renderers required by the current layer to renderer mapping
+  int m_maximumNumberOfRenderers{ 0 };
+  int m_nRequiredRenderers{ 0 };
+
+  // Unused renderers parked for reuse
+  std::vector<vtkSmartPointer<vtkRenderer>> m_rendererPool;
+  int m_rendererPoolSize{ 4 };
+  int m_nRendererPoolHits{ 0 };
+  int m_nRendererPoolMisses{ 0 };
+
+  // Camera to renderer map with the cached visible prop bounds of the renderers
+  mutable std::map<vtkWeakPointer<vtkCamera>, CameraGroup> m_cameraRendererMap;
+
+  // Cached visible prop bounds of the default renderer
+  mutable RendererBounds m_defaultRendererBounds;
+  mutable int m_nBoundsComputations{ 0 };
+
+  // Render orders of the layers rendered using an offscreen cache
+  std::set<unsigned int> m_cachedRenderOrders;
+
+  bool m_isSkipEmptyLayersDraw{ true };
+  int m_nSkippedLayerDraws{ 0 };
+
+  ClippingRangeMode m_clippingRangeMode{ VisiblePropBoundsClippingRange };
+  double m_slabThickness{ 1 };
+
+  bool m_isUpdateLayersBlocked{ false };
+  bool m_isUpdateLayersRequested{ false };
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 // Layer DM includes
+#include "vtkMRMLLayerDMPipelineCreatorI.h"
 #include "vtkMRMLLayerDMPipelineI.h"
 
 // VTK includes
@@ -44,4 +45,30 @@ vtkSmartPointer<vtkMRMLLayerDMPipelineI> TryCreate(vtkMRMLAbstractViewNode* view
   }
   return nullptr;
 }
+
+/// Helper template function to declare the types accepted by the input creator for the given view type.
+/// Supports the same variadic triplets as \sa TryCreateForView <TView, TNode, TPipeline, TNode2, TPipeline2 ...>
+/// \sa vtkMRMLLayerDMPipelineCreatorI::AddAcceptedTypes
+template <typename TExpView, typename TExpNode, typename TPipeline, typename... Rest>
+void AddAcceptedTypesForView(vtkMRMLLayerDMPipelineCreatorI* creator)
+{
+  creator->AddAcceptedTypes([](vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node) { return TExpView::SafeDownCast(viewNode) && TExpNode::SafeDownCast(node); });
+  if constexpr (sizeof...(Rest) > 0)
+  {
+    AddAcceptedTypesForView<TExpView, Rest...>(creator);
+  }
+}
+
+/// Helper template function to declare the types accepted by the input creator.
+/// Supports the same variadic triplets as \sa TryCreate <TView, TNode, TPipeline, TView2, TNode2, TPipeline2 ...>
+/// \sa vtkMRMLLayerDMPipelineCreatorI::AddAcceptedTypes
+template <typename TExpView, typename TExpNode, typename TPipeline, typename... Rest>
+void AddAcceptedTypes(vtkMRMLLayerDMPipelineCreatorI* creator)
+{
+  AddAcceptedTypesForView<TExpView, TExpNode, TPipeline>(creator);
+  if constexpr (sizeof...(Rest) > 0)
+  {
+    AddAcceptedTypes<Rest...>(creator);
+  }
+}
 }; // namespace layer_dm
@@ -1,12 +1,62 @@
 #include "vtkMRMLLayerDMPipelineCreatorI.h"
 
+// Slicer includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLNode.h>
+
 // VTK includes
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 
+// STL includes
+#include <algorithm>
+
 vtkStandardNewMacro(vtkMRMLLayerDMPipelineCreatorI);
 
 vtkSmartPointer<vtkMRMLLayerDMPipelineI> vtkMRMLLayerDMPipelineCreatorI::CreatePipeline(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node) const
 {
   return {};
 }
+
+void vtkMRMLLayerDMPipelineCreatorI::AddAcceptedTypes(const std::string& viewNodeClassName, const std::string& nodeClassName)
+{
+  this->AddAcceptedTypes([viewNodeClassName, nodeClassName](vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node)
+                         { return viewNode && node && viewNode->IsA(viewNodeClassName.c_str()) && node->IsA(nodeClassName.c_str()); });
+}
+
+void vtkMRMLLayerDMPipelineCreatorI::AddAcceptedTypes(const std::function<bool(vtkMRMLAbstractViewNode*, vtkMRMLNode*)>& matcher)
+{
+  if (!matcher)
+  {
+    return;
+  }
+
+  this->m_acceptedTypes.emplace_back(matcher);
+  this->Modified();
+}
+
+void vtkMRMLLayerDMPipelineCreatorI::ClearAcceptedTypes()
+{
+  if (this->m_acceptedTypes.empty())
+  {
+    return;
+  }
+
+  this->m_acceptedTypes.clear();
+  this->Modified();
+}
+
+bool vtkMRMLLayerDMPipelineCreatorI::HasAcceptedTypes() const
+{
+  return !this->m_acceptedTypes.empty();
+}
+
+bool vtkMRMLLayerDMPipelineCreatorI::AcceptsTypes(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node) const
+{
+  if (this->m_acceptedTypes.empty())
+  {
+    return true;
+  }
+
+  return std::any_of(this->m_acceptedTypes.begin(), this->m_acceptedTypes.end(), [&](const auto& matcher) { return matcher(viewNode, node); });
+}
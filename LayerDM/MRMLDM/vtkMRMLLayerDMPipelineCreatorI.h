@@ -7,11 +7,20 @@
 // VTK includes
 #include <vtkObject.h>
 
+// STL includes
+#include <functional>
+#include <string>
+#include <vector>
+
 class vtkMRMLAbstractViewNode;
 class vtkMRMLNode;
 
 /// \brief Interface responsible for creating new pipelines given input pairs of viewNode and node.
 ///
+/// Creators can declare the view node and node types they accept using \sa AddAcceptedTypes.
+/// The factory then only calls \sa CreatePipeline for matching view node / node classes.
+/// Creators without declared types are called for every view node / node pairs.
+///
 /// \sa vtkMRMLLayerDMPipelineCallbackCreator
 /// \sa vtkMRMLLayerDMPipelineFactory::AddPipelineCreator
 class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMPipelineCreatorI : public vtkObject
@@ -28,10 +37,43 @@ public:
   vtkGetMacro(Priority, int);
   vtkSetMacro(Priority, int);
   /// @}
+
+  /// @{
+  /// \brief Get/Set if the creator decision only depends on the view node and node classes.
+  /// When enabled, the factory is allowed to cache the (view node class, node class) pairs rejected by the creator and skip
+  /// calling \sa CreatePipeline for these pairs.
+  /// Defaults to false (the creator is always called).
+  /// \sa vtkMRMLLayerDMPipelineFactory::ClearNegativeCache
+  vtkGetMacro(ClassBasedDecision, bool);
+  vtkSetMacro(ClassBasedDecision, bool);
+  vtkBooleanMacro(ClassBasedDecision, bool);
+  /// @}
+
+  /// @{
+  /// \brief Declare a view node / node type pair accepted by the creator.
+  /// Types are matched using the class hierarchy (derived classes are accepted).
+  /// The matcher variant must only depend on the input classes.
+  /// Invokes vtkCommand::ModifiedEvent.
+  /// \sa layer_dm::AddAcceptedTypes
+  void AddAcceptedTypes(const std::string& viewNodeClassName, const std::string& nodeClassName);
+  void AddAcceptedTypes(const std::function<bool(vtkMRMLAbstractViewNode*, vtkMRMLNode*)>& matcher);
+  /// @}
+
+  /// Remove all the declared types.
+  /// Invokes vtkCommand::ModifiedEvent if types were declared.
+  void ClearAcceptedTypes();
+
+  /// Returns true if the creator declared its accepted types.
+  bool HasAcceptedTypes() const;
+
+  /// Returns true if the input pair matches one of the declared types or if the creator doesn't declare its types.
+  bool AcceptsTypes(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node) const;
 protected:
   vtkMRMLLayerDMPipelineCreatorI() = default;
   ~vtkMRMLLayerDMPipelineCreatorI() override = default;
 
 private:
   int Priority = 0;
+  bool ClassBasedDecision = false;
+  std::vector<std::function<bool(vtkMRMLAbstractViewNode*, vtkMRMLNode*)>> m_acceptedTypes;
 };
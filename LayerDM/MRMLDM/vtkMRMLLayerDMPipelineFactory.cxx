@@ -6,10 +6,18 @@
 #include "vtkMRMLLayerDMPipelineI.h"
 #include "vtkMRMLLayerDMObjectEventObserver.h"
 
+// Slicer includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLNode.h>
+
 // VTK includes
 #include <vtkCommand.h>
 #include <vtkObjectFactory.h>
 
+// STL includes
+#include <algorithm>
+#include <typeinfo>
+
 vtkStandardNewMacro(vtkMRMLLayerDMPipelineFactory);
 
 vtkSmartPointer<vtkMRMLLayerDMPipelineFactory> vtkMRMLLayerDMPipelineFactory::GetInstance()
@@ -27,7 +35,9 @@ void vtkMRMLLayerDMPipelineFactory::AddPipelineCreator(const vtkSmartPointer<vtk
 
   this->m_obs->UpdateObserver(nullptr, creator);
   this->m_pipelineCreators.emplace_back(creator);
+  this->InvalidateCreatorCaches();
   this->SortPipelineCreators();
+  this->InvokeEvent(PipelineCreatorAddedEvent, creator.GetPointer());
   this->InvokeEvent(vtkCommand::ModifiedEvent);
 }
 
@@ -52,6 +62,7 @@ void vtkMRMLLayerDMPipelineFactory::RemovePipelineCreator(const vtkSmartPointer<
                                  this->m_pipelineCreators.end());
   if (this->m_pipelineCreators.size() != prevSize)
   {
+    this->InvalidateCreatorCaches();
     this->InvokeEvent(vtkCommand::ModifiedEvent);
   }
 }
@@ -63,21 +74,134 @@ bool vtkMRMLLayerDMPipelineFactory::ContainsPipelineCreator(const vtkSmartPointe
 
 vtkSmartPointer<vtkMRMLLayerDMPipelineI> vtkMRMLLayerDMPipelineFactory::CreatePipeline(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node)
 {
-  for (const auto& ctor : m_pipelineCreators)
+  // Class keys are only available for non null inputs
+  if (!viewNode || !node)
   {
+    for (const auto& ctor : m_pipelineCreators)
+    {
+      if (!ctor->AcceptsTypes(viewNode, node))
+      {
+        continue;
+      }
+
+      if (auto created = ctor->CreatePipeline(viewNode, node))
+      {
+        this->NotifyPipelineCreated(viewNode, node, created);
+        return created;
+      }
+    }
+    return {};
+  }
+
+  // Class based creators are skipped if they previously rejected the same view node / node classes
+  const auto& classEntry = this->GetClassEntry(viewNode, node);
+  const bool isRejectedByClass = classEntry.IsRejected;
+
+  // Copy the candidates as creators may modify the factory during creation
+  const auto candidates = classEntry.Candidates;
+  for (const auto& ctor : candidates)
+  {
+    if (isRejectedByClass && ctor->GetClassBasedDecision())
+    {
+      continue;
+    }
+
     if (auto created = ctor->CreatePipeline(viewNode, node))
     {
-      this->m_lastView = viewNode;
-      this->m_lastNode = node;
-      this->m_lastPipeline = created;
-      this->InvokeEvent(PipelineAboutToBeCreatedEvent);
+      this->NotifyPipelineCreated(viewNode, node, created);
       return created;
     }
   }
 
+  // All the creators have rejected the pair, including the class based ones.
+  // The entry is looked up again as the caches may have been invalidated during creation.
+  this->GetClassEntry(viewNode, node).IsRejected = true;
   return {};
 }
 
+int vtkMRMLLayerDMPipelineFactory::GetNumberOfCandidateCreators(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node)
+{
+  if (!viewNode || !node)
+  {
+    return static_cast<int>(std::count_if(this->m_pipelineCreators.begin(),
+                                          this->m_pipelineCreators.end(),
+                                          [&](const vtkSmartPointer<vtkMRMLLayerDMPipelineCreatorI>& ctor) { return ctor->AcceptsTypes(viewNode, node); }));
+  }
+  return static_cast<int>(this->GetClassEntry(viewNode, node).Candidates.size());
+}
+
+vtkMRMLLayerDMPipelineFactory::ClassEntry& vtkMRMLLayerDMPipelineFactory::GetClassEntry(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node)
+{
+  // Lookup first to avoid allocating a map node for the already indexed pairs
+  const auto classKey = GetClassKey(viewNode, node);
+  auto found = this->m_classEntries.find(classKey);
+  if (found != this->m_classEntries.end())
+  {
+    return found->second;
+  }
+
+  // Declared types only depend on the classes, the candidates are valid for any node pair of the same classes
+  auto& classEntry = this->m_classEntries[classKey];
+  for (const auto& ctor : this->m_pipelineCreators)
+  {
+    if (ctor->AcceptsTypes(viewNode, node))
+    {
+      classEntry.Candidates.emplace_back(ctor);
+    }
+  }
+  return classEntry;
+}
+
+void vtkMRMLLayerDMPipelineFactory::InvalidateCreatorCaches()
+{
+  this->m_classEntries.clear();
+}
+
+void vtkMRMLLayerDMPipelineFactory::ClearNegativeCache()
+{
+  for (auto& classEntry : this->m_classEntries)
+  {
+    classEntry.second.IsRejected = false;
+  }
+}
+
+int vtkMRMLLayerDMPipelineFactory::GetNegativeCacheSize() const
+{
+  return static_cast<int>(std::count_if(this->m_classEntries.begin(),
+                                        this->m_classEntries.end(),
+                                        [](const std::pair<const ClassKey, ClassEntry>& classEntry) { return classEntry.second.IsRejected; }));
+}
+
+vtkMRMLLayerDMPipelineFactory::ClassKey vtkMRMLLayerDMPipelineFactory::GetClassKey(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node)
+{
+  return { std::type_index(typeid(*viewNode)), std::type_index(typeid(*node)) };
+}
+
+vtkSmartPointer<vtkMRMLLayerDMPipelineI> vtkMRMLLayerDMPipelineFactory::CreatePipelineWithCreator(vtkMRMLLayerDMPipelineCreatorI* creator,
+                                                                                                  vtkMRMLAbstractViewNode* viewNode,
+                                                                                                  vtkMRMLNode* node)
+{
+  if (!creator || !this->ContainsPipelineCreator(creator) || !creator->AcceptsTypes(viewNode, node))
+  {
+    return {};
+  }
+
+  auto created = creator->CreatePipeline(viewNode, node);
+  if (created)
+  {
+    this->NotifyPipelineCreated(viewNode, node, created);
+  }
+  return created;
+}
+
+void vtkMRMLLayerDMPipelineFactory::NotifyPipelineCreated(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node, vtkMRMLLayerDMPipelineI* pipeline)
+{
+  this->m_lastView = viewNode;
+  this->m_lastNode = node;
+  this->m_lastPipeline = pipeline;
+  this->InvokeEvent(PipelineAboutToBeCreatedEvent);
+}
+
 vtkMRMLAbstractViewNode* vtkMRMLLayerDMPipelineFactory::GetLastViewNode() const
 {
   return this->m_lastView;
@@ -103,7 +227,13 @@ vtkMRMLLayerDMPipelineFactory::vtkMRMLLayerDMPipelineFactory()
   , m_lastNode(nullptr)
   , m_lastPipeline(nullptr)
 {
-  m_obs->SetUpdateCallback([this](vtkObject* node) { this->SortPipelineCreators(); });
+  m_obs->SetUpdateCallback(
+    [this](vtkObject* node)
+    {
+      // Creator priority, class based decision or accepted types may have changed
+      this->InvalidateCreatorCaches();
+      this->SortPipelineCreators();
+    });
 }
 
 void vtkMRMLLayerDMPipelineFactory::SortPipelineCreators()
@@ -9,7 +9,11 @@
 #include <vtkWeakPointer.h>
 
 // STL includes
+#include <cstddef>
 #include <functional>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class vtkMRMLAbstractViewNode;
@@ -22,13 +26,24 @@ class vtkMRMLNode;
 ///
 /// Delegates creation to its list of \sa vtkMRMLLayerDMPipelineCreatorI.
 /// Early returns when a first creator capable of handling the input is found.
+///
+/// Creators declaring their accepted types are only called for matching view node / node classes.
+/// The candidate creators of each (view node class, node class) pair are indexed on first use.
+/// Creators without declared types are always candidates.
+/// \sa vtkMRMLLayerDMPipelineCreatorI::AddAcceptedTypes
+///
+/// The (view node class, node class) pairs rejected by all the creators declaring a class based decision are cached.
+/// These creators are not called again for the cached pairs until the cache is invalidated.
+/// \sa vtkMRMLLayerDMPipelineCreatorI::SetClassBasedDecision
 class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMPipelineFactory : public vtkObject
 {
 public:
   enum Events
   {
     // Triggered when the factory creates a non-empty pipeline
-    PipelineAboutToBeCreatedEvent = vtkCommand::UserEvent + 1
+    PipelineAboutToBeCreatedEvent = vtkCommand::UserEvent + 1,
+    // Triggered when a new creator is added to the factory (call data is the added creator)
+    PipelineCreatorAddedEvent
   };
 
   static vtkMRMLLayerDMPipelineFactory* New();
@@ -39,7 +54,7 @@ public:
 
   /// \brief Add the input creator to the list of creators.
   /// If the factory already contains the creator, does nothing.
-  /// Invokes vtkCommand::ModifiedEvent if the factory is modified.
+  /// Invokes PipelineCreatorAddedEvent and vtkCommand::ModifiedEvent if the factory is modified.
   void AddPipelineCreator(const vtkSmartPointer<vtkMRMLLayerDMPipelineCreatorI>& creator);
 
   /// Convenience method to add creator callback
@@ -66,6 +81,25 @@ public:
   /// \sa GetLastPipeline
   vtkSmartPointer<vtkMRMLLayerDMPipelineI> CreatePipeline(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node);
 
+  /// Clear the cache of (view node class, node class) pairs rejected by the class based creators.
+  /// The cache is automatically cleared when a creator is added, removed or modified (for instance when its priority changes).
+  void ClearNegativeCache();
+
+  /// Returns the number of (view node class, node class) pairs currently cached as rejected by the class based creators.
+  int GetNegativeCacheSize() const;
+
+  /// Returns the number of creators which may be called for the input pair (in priority order).
+  /// Creators not accepting the view node / node classes are excluded.
+  int GetNumberOfCandidateCreators(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node);
+
+  /// Tries to create a new pipeline given input viewNode and node using only the input creator.
+  /// Returns nullptr if the creator is not contained in the factory or if it cannot create a pipeline.
+  /// Invokes PipelineAboutToBeCreatedEvent before returning the newly created pipeline instance.
+  ///
+  /// Used to only probe a newly added creator for nodes which were previously rejected by the other creators.
+  /// \sa PipelineCreatorAddedEvent
+  vtkSmartPointer<vtkMRMLLayerDMPipelineI> CreatePipelineWithCreator(vtkMRMLLayerDMPipelineCreatorI* creator, vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node);
+
   /// @{
   /// Get the last pipeline created by the factory.
   /// Values are valid when the PipelineAboutToBeCreatedEvent event is triggered.
@@ -83,8 +117,43 @@ private:
   /// Updated when new creators are added / removed or when creators modified events are triggered.
   void SortPipelineCreators();
 
+  /// (view node class, node class) key. Type indices are compared without building the class name strings.
+  using ClassKey = std::pair<std::type_index, std::type_index>;
+
+  struct ClassKeyHash
+  {
+    std::size_t operator()(const ClassKey& key) const
+    {
+      const std::size_t viewHash = std::hash<std::type_index>{}(key.first);
+      return viewHash ^ (std::hash<std::type_index>{}(key.second) + 0x9e3779b9 + (viewHash << 6) + (viewHash >> 2));
+    }
+  };
+
+  /// Cached creation state of a (view node class, node class) pair.
+  struct ClassEntry
+  {
+    /// Creators accepting the pair classes sorted by priority
+    std::vector<vtkMRMLLayerDMPipelineCreatorI*> Candidates;
+    /// True if the pair was rejected by all the creators (negative cache)
+    bool IsRejected{ false };
+  };
+
+  /// Returns the class key of the input pair.
+  static ClassKey GetClassKey(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node);
+
+  /// Returns the cached entry of the input pair classes.
+  /// The candidate creators are indexed on first call.
+  ClassEntry& GetClassEntry(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node);
+
+  /// Clear the negative cache and the candidate creator index.
+  void InvalidateCreatorCaches();
+
+  /// Store the created pipeline as last created and notify PipelineAboutToBeCreatedEvent.
+  void NotifyPipelineCreated(vtkMRMLAbstractViewNode* viewNode, vtkMRMLNode* node, vtkMRMLLayerDMPipelineI* pipeline);
+
   std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineCreatorI>> m_pipelineCreators;
   vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver> m_obs;
+  std::unordered_map<ClassKey, ClassEntry, ClassKeyHash> m_classEntries;
   vtkWeakPointer<vtkMRMLAbstractViewNode> m_lastView;
   vtkWeakPointer<vtkMRMLNode> m_lastNode;
   vtkWeakPointer<vtkMRMLLayerDMPipelineI> m_lastPipeline;
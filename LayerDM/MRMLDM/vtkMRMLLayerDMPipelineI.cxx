@@ -10,10 +10,25 @@
 #include <vtkObjectFactory.h>
 #include <vtkRenderer.h>
 
+// STL includes
+#include <algorithm>
+
 vtkStandardNewMacro(vtkMRMLLayerDMPipelineI);
 
 void vtkMRMLLayerDMPipelineI::UpdatePipeline() {}
 
+vtkSmartPointer<vtkObject> vtkMRMLLayerDMPipelineI::CreateUpdateSnapshot()
+{
+  return nullptr;
+}
+
+vtkSmartPointer<vtkObject> vtkMRMLLayerDMPipelineI::PrepareUpdate(vtkObject* snapshot) const
+{
+  return nullptr;
+}
+
+void vtkMRMLLayerDMPipelineI::CommitUpdate(vtkObject* preparedData) {}
+
 void vtkMRMLLayerDMPipelineI::OnRendererRemoved(vtkRenderer* renderer) {}
 
 void vtkMRMLLayerDMPipelineI::OnRendererAdded(vtkRenderer* renderer) {}
@@ -31,13 +46,84 @@ void vtkMRMLLayerDMPipelineI::ResetDisplay()
     return;
   }
 
+  if (this->m_isAsynchronousUpdate && this->m_pipelineManager)
+  {
+    this->m_pipelineManager->SchedulePipelineUpdate(this);
+    return;
+  }
+
+  if (this->m_isDeferredResetDisplay && this->m_pipelineManager)
+  {
+    this->m_pipelineManager->MarkPipelineDirty(this);
+    return;
+  }
+
+  this->ResetDisplayNow();
+}
+
+void vtkMRMLLayerDMPipelineI::ResetDisplayNow()
+{
+  if (this->m_isResetDisplayBlocked || !this->m_viewNode)
+  {
+    return;
+  }
+
+  if (this->m_pipelineManager)
+  {
+    this->m_pipelineManager->UnmarkPipelineDirty(this);
+    this->m_pipelineManager->CancelPipelineUpdate(this);
+  }
+
   // Make sure to avoid looping reset display during processing
   this->BlockResetDisplay(true);
-  this->UpdatePipeline();
+  {
+    PerformanceCounterGuard counterGuard{ this, UpdatePipelineDispatch };
+    this->UpdatePipeline();
+  }
   this->RequestRender();
   this->BlockResetDisplay(false);
 }
 
+void vtkMRMLLayerDMPipelineI::SetDeferredResetDisplay(bool isDeferred)
+{
+  this->m_isDeferredResetDisplay = isDeferred;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsDeferredResetDisplay() const
+{
+  return this->m_isDeferredResetDisplay;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsDirty() const
+{
+  return this->m_pipelineManager && this->m_pipelineManager->IsPipelineDirty(this);
+}
+
+void vtkMRMLLayerDMPipelineI::SetAsynchronousUpdate(bool isAsynchronous)
+{
+  this->m_isAsynchronousUpdate = isAsynchronous;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsAsynchronousUpdate() const
+{
+  return this->m_isAsynchronousUpdate;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsUpdatePending() const
+{
+  return this->m_pipelineManager && this->m_pipelineManager->IsPipelineUpdatePending(this);
+}
+
+void vtkMRMLLayerDMPipelineI::SetReentrantCanProcessInteractionEvent(bool isReentrant)
+{
+  this->m_isReentrantCanProcessInteractionEvent = isReentrant;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsReentrantCanProcessInteractionEvent() const
+{
+  return this->m_isReentrantCanProcessInteractionEvent;
+}
+
 void vtkMRMLLayerDMPipelineI::SetViewNode(vtkMRMLAbstractViewNode* viewNode)
 {
   this->UpdateObserver(this->m_viewNode, viewNode);
@@ -51,9 +137,15 @@ void vtkMRMLLayerDMPipelineI::SetRenderer(vtkRenderer* renderer)
     return;
   }
 
-  this->OnRendererRemoved(this->m_renderer);
+  {
+    PerformanceCounterGuard counterGuard{ this, OnRendererRemovedDispatch };
+    this->OnRendererRemoved(this->m_renderer);
+  }
   this->m_renderer = renderer;
-  this->OnRendererAdded(this->m_renderer);
+  {
+    PerformanceCounterGuard counterGuard{ this, OnRendererAddedDispatch };
+    this->OnRendererAdded(this->m_renderer);
+  }
   this->ResetDisplay();
 }
 
@@ -86,6 +178,48 @@ bool vtkMRMLLayerDMPipelineI::IsInteractionProcessingBlocked() const
   return this->m_isInteractionProcessingBlocked;
 }
 
+void vtkMRMLLayerDMPipelineI::SetWorldInteractionBounds(const double bounds[6])
+{
+  this->SetInteractionBounds(WorldInteractionBounds, bounds, 6);
+}
+
+void vtkMRMLLayerDMPipelineI::SetDisplayInteractionBounds(const double bounds[4])
+{
+  this->SetInteractionBounds(DisplayInteractionBounds, bounds, 4);
+}
+
+void vtkMRMLLayerDMPipelineI::RemoveInteractionBounds()
+{
+  this->SetInteractionBounds(NoInteractionBounds, nullptr, 0);
+}
+
+void vtkMRMLLayerDMPipelineI::SetInteractionBounds(InteractionBoundsSpace space, const double* bounds, int nValues)
+{
+  std::array<double, 6> interactionBounds{};
+  std::copy_n(bounds, nValues, interactionBounds.begin());
+  if (this->m_interactionBoundsSpace == space && this->m_interactionBounds == interactionBounds)
+  {
+    return;
+  }
+
+  this->m_interactionBoundsSpace = space;
+  this->m_interactionBounds = interactionBounds;
+  if (this->m_pipelineManager)
+  {
+    this->m_pipelineManager->UpdatePipelineInteractionBounds(this);
+  }
+}
+
+int vtkMRMLLayerDMPipelineI::GetInteractionBoundsSpace() const
+{
+  return this->m_interactionBoundsSpace;
+}
+
+void vtkMRMLLayerDMPipelineI::GetInteractionBounds(double bounds[6]) const
+{
+  std::copy(this->m_interactionBounds.begin(), this->m_interactionBounds.end(), bounds);
+}
+
 bool vtkMRMLLayerDMPipelineI::CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2)
 {
   return false;
@@ -112,11 +246,13 @@ void vtkMRMLLayerDMPipelineI::OnDefaultCameraModified(vtkCamera* camera) {}
 
 void vtkMRMLLayerDMPipelineI::OnReferenceToDisplayNodeAdded(vtkMRMLNode* fromNode, const std::string& role)
 {
+  PerformanceCounterGuard counterGuard{ this, OnUpdateDispatch };
   this->OnUpdate(this->GetDisplayNode(), vtkMRMLNode::ReferenceAddedEvent, nullptr);
 }
 
 void vtkMRMLLayerDMPipelineI::OnReferenceToDisplayNodeRemoved(vtkMRMLNode* fromNode, const std::string& role)
 {
+  PerformanceCounterGuard counterGuard{ this, OnUpdateDispatch };
   this->OnUpdate(this->GetDisplayNode(), vtkMRMLNode::ReferenceRemovedEvent, nullptr);
 }
 
@@ -135,6 +271,32 @@ unsigned int vtkMRMLLayerDMPipelineI::GetRenderOrder() const
   return 0;
 }
 
+void vtkMRMLLayerDMPipelineI::RenderOrderChanged()
+{
+  if (this->m_pipelineManager)
+  {
+    this->m_pipelineManager->UpdatePipelineLayer(this);
+  }
+}
+
+void vtkMRMLLayerDMPipelineI::CustomCameraChanged()
+{
+  if (this->m_pipelineManager)
+  {
+    this->m_pipelineManager->UpdatePipelineLayer(this);
+  }
+}
+
+void vtkMRMLLayerDMPipelineI::SetUsesCustomRenderPass(bool usesCustomRenderPass)
+{
+  this->m_usesCustomRenderPass = usesCustomRenderPass;
+}
+
+bool vtkMRMLLayerDMPipelineI::UsesCustomRenderPass() const
+{
+  return this->m_usesCustomRenderPass;
+}
+
 vtkCamera* vtkMRMLLayerDMPipelineI::GetCustomCamera() const
 {
   return nullptr;
@@ -242,8 +404,105 @@ vtkMRMLLayerDMPipelineI::vtkMRMLLayerDMPipelineI()
   , m_isResetDisplayBlocked{ false }
   , m_isFrozen{ false }
   , m_isInteractionProcessingBlocked{ false }
+  , m_isDeferredResetDisplay{ false }
+  , m_usesCustomRenderPass{ false }
+  , m_isAsynchronousUpdate{ false }
+  , m_isReentrantCanProcessInteractionEvent{ false }
+  , m_isPerformanceCountersEnabled{ false }
+  , m_interactionBoundsSpace{ NoInteractionBounds }
+  , m_interactionBounds{}
+  , m_performanceCounters{}
   , m_obs(vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver>::New())
   , m_pipelineManager(nullptr)
 {
-  this->m_obs->SetUpdateCallback([this](vtkObject* obj, unsigned long eventId, void* callData) { this->OnUpdate(obj, eventId, callData); });
+  this->m_obs->SetUpdateCallback(
+    [this](vtkObject* obj, unsigned long eventId, void* callData)
+    {
+      PerformanceCounterGuard counterGuard{ this, OnUpdateDispatch };
+      this->OnUpdate(obj, eventId, callData);
+    });
+}
+
+void vtkMRMLLayerDMPipelineI::SetPerformanceCountersEnabled(bool isEnabled)
+{
+  this->m_isPerformanceCountersEnabled = isEnabled;
+}
+
+bool vtkMRMLLayerDMPipelineI::IsPerformanceCountersEnabled() const
+{
+  return this->m_isPerformanceCountersEnabled;
+}
+
+int vtkMRMLLayerDMPipelineI::GetCallCount(int dispatchPoint) const
+{
+  if (dispatchPoint < 0 || dispatchPoint >= NumberOfDispatchPoints)
+  {
+    return 0;
+  }
+  return this->m_performanceCounters[dispatchPoint].CallCount;
+}
+
+double vtkMRMLLayerDMPipelineI::GetTotalTime(int dispatchPoint) const
+{
+  if (dispatchPoint < 0 || dispatchPoint >= NumberOfDispatchPoints)
+  {
+    return 0;
+  }
+  return this->m_performanceCounters[dispatchPoint].TotalTime;
+}
+
+double vtkMRMLLayerDMPipelineI::GetMaxTime(int dispatchPoint) const
+{
+  if (dispatchPoint < 0 || dispatchPoint >= NumberOfDispatchPoints)
+  {
+    return 0;
+  }
+  return this->m_performanceCounters[dispatchPoint].MaxTime;
+}
+
+void vtkMRMLLayerDMPipelineI::ResetPerformanceCounters()
+{
+  this->m_performanceCounters.fill(PerformanceCounter{});
+}
+
+const char* vtkMRMLLayerDMPipelineI::GetDispatchPointName(int dispatchPoint)
+{
+  switch (dispatchPoint)
+  {
+    case UpdatePipelineDispatch: return "UpdatePipeline";
+    case OnUpdateDispatch: return "OnUpdate";
+    case CanProcessInteractionEventDispatch: return "CanProcessInteractionEvent";
+    case ProcessInteractionEventDispatch: return "ProcessInteractionEvent";
+    case OnDefaultCameraModifiedDispatch: return "OnDefaultCameraModified";
+    case OnRendererAddedDispatch: return "OnRendererAdded";
+    case OnRendererRemovedDispatch: return "OnRendererRemoved";
+    default: return "";
+  }
+}
+
+void vtkMRMLLayerDMPipelineI::RecordDispatch(DispatchPoint dispatchPoint, double duration)
+{
+  auto& counter = this->m_performanceCounters[dispatchPoint];
+  counter.CallCount++;
+  counter.TotalTime += duration;
+  counter.MaxTime = std::max(counter.MaxTime, duration);
+}
+
+vtkMRMLLayerDMPipelineI::PerformanceCounterGuard::PerformanceCounterGuard(vtkMRMLLayerDMPipelineI* pipeline, DispatchPoint dispatchPoint)
+  : m_pipeline{ pipeline && pipeline->m_isPerformanceCountersEnabled ? pipeline : nullptr }
+  , m_dispatchPoint{ dispatchPoint }
+{
+  if (this->m_pipeline)
+  {
+    this->m_start = std::chrono::steady_clock::now();
+  }
+}
+
+vtkMRMLLayerDMPipelineI::PerformanceCounterGuard::~PerformanceCounterGuard()
+{
+  if (this->m_pipeline)
+  {
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - this->m_start;
+    this->m_pipeline->RecordDispatch(this->m_dispatchPoint, duration.count());
+  }
 }
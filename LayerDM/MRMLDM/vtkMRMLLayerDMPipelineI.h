@@ -9,6 +9,10 @@
 #include <vtkCommand.h>
 #include <vtkObject.h>
 
+// STL includes
+#include <array>
+#include <chrono>
+
 class vtkCamera;
 class vtkMRMLAbstractViewNode;
 class vtkMRMLInteractionEventData;
@@ -35,6 +39,19 @@ public:
   static vtkMRMLLayerDMPipelineI* New();
   vtkTypeMacro(vtkMRMLLayerDMPipelineI, vtkObject);
 
+  /// Virtual dispatch points measured by the pipeline performance counters.
+  enum DispatchPoint
+  {
+    UpdatePipelineDispatch = 0,
+    OnUpdateDispatch,
+    CanProcessInteractionEventDispatch,
+    ProcessInteractionEventDispatch,
+    OnDefaultCameraModifiedDispatch,
+    OnRendererAddedDispatch,
+    OnRendererRemovedDispatch,
+    NumberOfDispatchPoints
+  };
+
   /// true if the pipeline can process the input event data
   /// \param eventData: The MRML event needing to be processed
   /// \param distance2: Return value for the distance to the interaction (preferably actual RAS distance)
@@ -44,6 +61,7 @@ public:
   /// Custom pipeline camera.
   /// If the returned value is not nullptr, then the pipeline (or dedicated logic) is expected to handle its own camera.
   /// Otherwise, the pipeline will be moved in a renderer with a default camera synchronized on its view default camera.
+  /// If the returned camera changes after the pipeline was added, \sa CustomCameraChanged should be called.
   /// \sa vtkMRMLLayerDMCameraSynchronizer
   /// \return nullptr by default.
   virtual vtkCamera* GetCustomCamera() const;
@@ -55,12 +73,35 @@ public:
   /// Arbitrary render order number where the pipeline wants to be displayed.
   /// Return 0 to be at the default order (main 3D Slicer pipelines)
   /// Return larger values to be rendered on top of pipelines with lower render orders.
-  /// Order number is read-only during update and is expected to be static per pipeline.
+  /// Order number is read-only during update. If it changes after the pipeline was added, \sa RenderOrderChanged should
+  /// be called.
   ///
   /// \sa vtkMRMLLayerDMLayerManager
   /// \return default = 0
   virtual unsigned int GetRenderOrder() const;
 
+  /// @{
+  /// Notify the pipeline manager that the value returned by \sa GetRenderOrder or \sa GetCustomCamera has changed.
+  /// The pipeline is moved to its new layer and a render is requested. The move is incremental when both the previous
+  /// and new layers are in use by other pipelines, which is cheaper than recreating the pipeline (for instance to
+  /// bring a selected widget to the front).
+  /// \sa vtkMRMLLayerDMLayerManager::UpdatePipelineLayer
+  void RenderOrderChanged();
+  void CustomCameraChanged();
+  /// @}
+
+  /// @{
+  /// Set to true if the pipeline installs a custom render pass on its renderer (for instance in \sa OnRendererAdded).
+  /// Layers containing such pipelines always get their own renderer and are never merged with other layers when the
+  /// layer manager renderer budget is exceeded.
+  /// Like the render order, the value is expected to be static per pipeline.
+  /// Default = false.
+  ///
+  /// \sa vtkMRMLLayerDMLayerManager::SetMaximumNumberOfRenderers
+  void SetUsesCustomRenderPass(bool usesCustomRenderPass);
+  bool UsesCustomRenderPass() const;
+  /// @}
+
   /// Current widget state of the pipeline.
   /// \return default = WidgetStateIdle
   virtual int GetWidgetState() const;
@@ -120,6 +161,24 @@ public:
   /// default behavior: does nothing.
   virtual void UpdatePipeline();
 
+  /// @{
+  /// Optional two-phase update used when \sa SetAsynchronousUpdate is enabled.
+  ///
+  /// \sa CreateUpdateSnapshot is called on the main thread and copies the node state needed by the update.
+  /// \sa PrepareUpdate is called on a worker thread with the snapshot and produces the update data. It must be thread-safe
+  /// and must not access the MRML nodes, the scene or the renderers.
+  /// \sa CommitUpdate is called on the main thread with the prepared data and swaps the VTK inputs of the pipeline.
+  /// Until the commit, the pipeline keeps rendering its previous result.
+  ///
+  /// Two-phase pipelines are expected to keep \sa UpdatePipeline as synchronous fallback (\sa ResetDisplayNow).
+  /// default behavior: no snapshot, no prepared data and does nothing on commit.
+  ///
+  /// \sa vtkMRMLLayerDMPipelineManager::SchedulePipelineUpdate
+  virtual vtkSmartPointer<vtkObject> CreateUpdateSnapshot();
+  virtual vtkSmartPointer<vtkObject> PrepareUpdate(vtkObject* snapshot) const;
+  virtual void CommitUpdate(vtkObject* preparedData);
+  /// @}
+
   /// If \param isBlocked is true, \sa UpdatePipeline is not called during \sa ResetDisplay.
   bool BlockResetDisplay(bool isBlocked);
 
@@ -130,6 +189,37 @@ public:
   bool IsInteractionProcessingBlocked() const;
   /// @}
 
+  /// Coordinate space of the optional pipeline interaction bounds.
+  enum InteractionBoundsSpace
+  {
+    NoInteractionBounds = 0,
+    WorldInteractionBounds,
+    DisplayInteractionBounds
+  };
+
+  /// @{
+  /// Optional bounds outside of which the pipeline never processes interactions.
+  /// World bounds are (xmin, xmax, ymin, ymax, zmin, zmax) in RAS, display bounds are (xmin, xmax, ymin, ymax) in pixels.
+  /// The bounds are expected to include the pick tolerance of the pipeline.
+  ///
+  /// When set, \sa CanProcessInteractionEvent is only called for events whose world (resp. display) position is
+  /// inside the bounds, or when the pipeline has the interaction focus. Events without valid position are always
+  /// forwarded. Pipelines without bounds are asked for every event (default).
+  ///
+  /// World bounds are tested against the event world position in slice views only. In 3D views, the picked world
+  /// position may be behind the pipeline : the bounds are tested against the camera ray through the event display
+  /// position. 3D events without renderer are forwarded to all the world bounded pipelines. The pick ray uses the
+  /// default camera, world bounds of pipelines with a \sa GetCustomCamera are not used in 3D views.
+  ///
+  /// Setting the bounds again in the same space only refits the interaction logic bounding volume hierarchy.
+  /// \sa vtkMRMLLayerDMInteractionLogic
+  void SetWorldInteractionBounds(const double bounds[6]);
+  void SetDisplayInteractionBounds(const double bounds[4]);
+  void RemoveInteractionBounds();
+  int GetInteractionBoundsSpace() const;
+  void GetInteractionBounds(double bounds[6]) const;
+  /// @}
+
   /// @{
   /// If \param isBlocked is true, blocks \sa OnUpdate method from being triggered by external changes.
   bool BlockUpdateObserver(bool isBlocked) const;
@@ -193,8 +283,93 @@ public:
   /// Resets the pipeline display and request a new render \sa RequestRender.
   /// Delegates actual work to \sa UpdatePipeline.
   /// Called the first time after pipeline initialization.
+  ///
+  /// If the reset display is deferred, marks the pipeline dirty instead.
+  /// \sa SetDeferredResetDisplay
   void ResetDisplay();
 
+  /// Synchronous version of \sa ResetDisplay.
+  /// Resets the display immediately even if the reset display is deferred and discards the pending deferred reset if any.
+  void ResetDisplayNow();
+
+  /// @{
+  /// If \param isDeferred is true, \sa ResetDisplay calls mark the pipeline dirty in its pipeline manager instead of
+  /// updating the pipeline immediately. The pipeline is then updated once right before the next render, whatever the number
+  /// of \sa ResetDisplay calls in between.
+  /// Default = false.
+  ///
+  /// \sa vtkMRMLLayerDMPipelineManager::MarkPipelineDirty
+  void SetDeferredResetDisplay(bool isDeferred);
+  bool IsDeferredResetDisplay() const;
+  /// @}
+
+  /// Returns true if the pipeline has a pending deferred reset display.
+  bool IsDirty() const;
+
+  /// @{
+  /// If \param isAsynchronous is true, \sa ResetDisplay calls schedule a two-phase update in the pipeline manager
+  /// (\sa PrepareUpdate on a worker thread followed by \sa CommitUpdate on the main thread).
+  /// Scheduling a new update cancels the previous update if it was not committed yet.
+  /// Default = false.
+  ///
+  /// \warning Scripted pipelines don't support asynchronous updates.
+  void SetAsynchronousUpdate(bool isAsynchronous);
+  bool IsAsynchronousUpdate() const;
+  /// @}
+
+  /// Returns true if the pipeline has a scheduled asynchronous update not committed yet.
+  bool IsUpdatePending() const;
+
+  /// @{
+  /// If \param isReentrant is true, the pipeline declares its \sa CanProcessInteractionEvent reentrant and read-only.
+  /// The interaction logic may then call it from worker threads, concurrently with the other declaring pipelines, when
+  /// the number of interaction candidates is large enough.
+  ///
+  /// The main thread waits for the workers, but declaring pipelines must not modify any state from
+  /// \sa CanProcessInteractionEvent, including through calls with hidden side effects (lazily computed VTK bounds,
+  /// vtkMRMLInteractionEventData::ComputeAccurateWorldPosition...). The other methods are always called on the main thread.
+  /// Default = false.
+  ///
+  /// \warning Scripted pipelines are always polled on the main thread.
+  /// \sa vtkMRMLLayerDMInteractionLogic::SetConcurrentPollingThreshold
+  void SetReentrantCanProcessInteractionEvent(bool isReentrant);
+  virtual bool IsReentrantCanProcessInteractionEvent() const;
+  /// @}
+
+  /// @{
+  /// Enable / disable the performance counters of the pipeline.
+  /// When disabled, dispatch points only check the enabled flag.
+  /// \sa vtkMRMLLayerDMPipelineManager::SetPerformanceCountersEnabled
+  void SetPerformanceCountersEnabled(bool isEnabled);
+  bool IsPerformanceCountersEnabled() const;
+  /// @}
+
+  /// @{
+  /// Performance counters of the input \sa DispatchPoint.
+  /// Times are wall times in seconds and include the nested dispatch points (for instance OnUpdate includes the
+  /// UpdatePipeline calls it triggers).
+  int GetCallCount(int dispatchPoint) const;
+  double GetTotalTime(int dispatchPoint) const;
+  double GetMaxTime(int dispatchPoint) const;
+  void ResetPerformanceCounters();
+  /// @}
+
+  /// Returns the name of the input \sa DispatchPoint.
+  static const char* GetDispatchPointName(int dispatchPoint);
+
+  /// Helper RAII struct recording the duration of a dispatch point call in the pipeline performance counters.
+  /// Does nothing if the pipeline is nullptr or if its performance counters are disabled.
+  struct PerformanceCounterGuard
+  {
+    PerformanceCounterGuard(vtkMRMLLayerDMPipelineI* pipeline, DispatchPoint dispatchPoint);
+    ~PerformanceCounterGuard();
+
+  private:
+    vtkMRMLLayerDMPipelineI* m_pipeline;
+    DispatchPoint m_dispatchPoint;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
   /// Set the new renderer.
   /// Triggers \sa OnRendererAdded and \sa OnRendererRemoved if renderer has changed.
   void SetRenderer(vtkRenderer* renderer);
@@ -208,12 +383,30 @@ protected:
   virtual void OnUpdate(vtkObject* obj, unsigned long eventId, void* callData);
 
 private:
+  struct PerformanceCounter
+  {
+    int CallCount{};
+    double TotalTime{};
+    double MaxTime{};
+  };
+
+  void RecordDispatch(DispatchPoint dispatchPoint, double duration);
+  void SetInteractionBounds(InteractionBoundsSpace space, const double* bounds, int nValues);
+
   vtkWeakPointer<vtkMRMLAbstractViewNode> m_viewNode;
   vtkWeakPointer<vtkMRMLNode> m_displayNode;
   vtkWeakPointer<vtkRenderer> m_renderer;
   bool m_isResetDisplayBlocked;
   bool m_isFrozen;
   bool m_isInteractionProcessingBlocked;
+  bool m_isDeferredResetDisplay;
+  bool m_usesCustomRenderPass;
+  bool m_isAsynchronousUpdate;
+  bool m_isReentrantCanProcessInteractionEvent;
+  bool m_isPerformanceCountersEnabled;
+  InteractionBoundsSpace m_interactionBoundsSpace;
+  std::array<double, 6> m_interactionBounds;
+  std::array<PerformanceCounter, NumberOfDispatchPoints> m_performanceCounters;
   vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver> m_obs;
   vtkWeakPointer<vtkMRMLLayerDMPipelineManager> m_pipelineManager;
   vtkWeakPointer<vtkMRMLScene> m_scene;
@@ -2,25 +2,40 @@
 
 // Layer DM includes
 #include "vtkMRMLLayerDMCameraSynchronizer.h"
+#include "vtkMRMLLayerDMInteractionLatency.h"
 #include "vtkMRMLLayerDMInteractionLogic.h"
 #include "vtkMRMLLayerDMLayerManager.h"
 #include "vtkMRMLLayerDMNodeReferenceObserver.h"
 #include "vtkMRMLLayerDMObjectEventObserver.h"
 #include "vtkMRMLLayerDMPipelineFactory.h"
 #include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMTracer.h"
 
 // Slicer includes
 #include "vtkMRMLAbstractViewNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLSliceNode.h"
 
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCamera.h>
 #include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
 #include <vtkRenderer.h>
 
+// STL includes
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <thread>
+
 vtkStandardNewMacro(vtkMRMLLayerDMPipelineManager);
 
+namespace
+{
+constexpr unsigned long CommitTimerPeriodMs = 10;
+} // namespace
+
 /// Helper struct to block reset display and reset display once when deleting
 struct ResetPipelineDisplayOnceGuard
 {
@@ -73,74 +88,212 @@ bool vtkMRMLLayerDMPipelineManager::CreatePipelineForNode(vtkMRMLNode* displayNo
     return false;
   }
 
+  vtkMRMLLayerDMTracer::Scope traceScope{ "CreatePipeline", "pipeline" };
+  traceScope.SetNode(displayNode).SetView(this->m_viewNode);
   auto pipeline = this->m_factory->CreatePipeline(this->m_viewNode, displayNode);
   if (!pipeline)
   {
     return false;
   }
 
+  traceScope.SetPipeline(pipeline);
+  this->AddCreatedPipeline(displayNode, pipeline);
+  return true;
+}
+
+void vtkMRMLLayerDMPipelineManager::AddCreatedPipeline(vtkMRMLNode* displayNode, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline)
+{
   RequestRenderOnceGuard renderGuard{ *this };
   ResetPipelineDisplayOnceGuard resetPipelineGuard{ pipeline };
+  this->RegisterPipeline(displayNode, pipeline);
+  this->UpdatePipeline(pipeline);
+  this->InvokePipelinesModified();
+}
+
+void vtkMRMLLayerDMPipelineManager::RegisterPipeline(vtkMRMLNode* displayNode, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline)
+{
+  pipeline->SetPerformanceCountersEnabled(this->m_isPerformanceCountersEnabled);
   pipeline->SetViewNode(this->m_viewNode);
   pipeline->SetPipelineManager(this);
   pipeline->SetScene(this->m_scene);
   pipeline->SetViewNode(this->m_viewNode);
   pipeline->SetDisplayNode(displayNode);
-  pipeline->OnDefaultCameraModified(this->m_defaultCamera);
-  this->m_pipelineMap[displayNode] = pipeline;
+  {
+    vtkMRMLLayerDMPipelineI::PerformanceCounterGuard counterGuard{ pipeline, vtkMRMLLayerDMPipelineI::OnDefaultCameraModifiedDispatch };
+    pipeline->OnDefaultCameraModified(this->m_defaultCamera);
+  }
+  // Remove the pipeline of a deleted node previously registered at the same address
+  if (!this->m_pipelines.Contains(displayNode) && this->m_pipelines.FindByKey(displayNode))
+  {
+    this->RemovePipeline(displayNode);
+  }
+  this->m_pipelines.Insert(displayNode, pipeline);
   this->m_layerManager->AddPipeline(pipeline);
   this->m_interactionLogic->AddPipeline(pipeline);
-  this->UpdatePipeline(pipeline);
+}
+
+void vtkMRMLLayerDMPipelineManager::InvokePipelinesModified()
+{
+  if (this->m_isBatchProcessing)
+  {
+    this->m_isBatchModified = true;
+    return;
+  }
   this->InvokeEvent(vtkCommand::ModifiedEvent);
-  return true;
 }
 
 void vtkMRMLLayerDMPipelineManager::ClearDisplayableNodes()
 {
-  this->m_pipelineMap.clear();
+  this->m_pipelines.Clear();
+  this->m_pendingNodes.clear();
+  this->m_pendingNodeSet.clear();
+  this->m_dirtyPipelines.clear();
+  this->m_dirtyPipelineSet.clear();
+  for (auto& pair : this->m_updateStates)
+  {
+    this->CancelPipelineUpdate(pair.first);
+  }
+  this->m_updateStates.clear();
+  this->m_sceneAddedNodes.clear();
+  this->m_sceneRemovedNodes.clear();
+  this->m_lastAddedNode = nullptr;
 }
 
 bool vtkMRMLLayerDMPipelineManager::AddNode(vtkMRMLNode* node)
 {
+  // The node is processed, it doesn't need to be processed on next scene update
+  this->m_sceneAddedNodes.erase(node);
+  this->m_lastAddedNode = node;
+
   if (auto pipeline = this->GetNodePipeline(node))
   {
     return false;
   }
 
+  if (this->m_isBatchProcessing)
+  {
+    if (node && this->m_pendingNodeSet.insert(node).second)
+    {
+      this->m_pendingNodes.emplace_back(node);
+    }
+    return false;
+  }
+
   return this->CreatePipelineForNode(node);
 }
 
+void vtkMRMLLayerDMPipelineManager::StartBatchProcess()
+{
+  if (this->m_isBatchProcessing)
+  {
+    return;
+  }
+
+  this->m_isBatchProcessing = true;
+  this->m_isBatchModified = false;
+  this->m_wasRequestRenderBlockedBeforeBatch = this->BlockRequestRender(true);
+  this->m_layerManager->BlockUpdateLayers(true);
+}
+
+void vtkMRMLLayerDMPipelineManager::EndBatchProcess()
+{
+  if (!this->m_isBatchProcessing)
+  {
+    return;
+  }
+
+  this->BlockRequestRender(this->m_wasRequestRenderBlockedBeforeBatch);
+  RequestRenderOnceGuard renderGuard{ *this };
+  this->CreatePendingPipelines();
+  this->m_isBatchProcessing = false;
+
+  if (this->m_isBatchModified)
+  {
+    this->m_isBatchModified = false;
+    this->InvokeEvent(vtkCommand::ModifiedEvent);
+  }
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsBatchProcessing() const
+{
+  return this->m_isBatchProcessing;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfPendingNodes() const
+{
+  return static_cast<int>(this->m_pendingNodes.size());
+}
+
+void vtkMRMLLayerDMPipelineManager::CreatePendingPipelines()
+{
+  // Pipelines are created and configured while the layers are still blocked.
+  // Their display is reset once, after the single layer update has provided them with their renderer.
+  std::deque<ResetPipelineDisplayOnceGuard> resetPipelineGuards;
+  if (this->m_factory && this->m_viewNode)
+  {
+    for (const auto& node : this->m_pendingNodes)
+    {
+      if (!node || this->GetNodePipeline(node))
+      {
+        continue;
+      }
+
+      auto pipeline = this->m_factory->CreatePipeline(this->m_viewNode, node);
+      if (!pipeline)
+      {
+        continue;
+      }
+
+      resetPipelineGuards.emplace_back(pipeline);
+      this->RegisterPipeline(node, pipeline);
+      this->m_isBatchModified = true;
+    }
+  }
+  this->m_pendingNodes.clear();
+  this->m_pendingNodeSet.clear();
+
+  this->m_layerManager->BlockUpdateLayers(false);
+  resetPipelineGuards.clear();
+}
+
 void vtkMRMLLayerDMPipelineManager::UpdateAllPipelines()
 {
   RequestRenderOnceGuard renderGuard{ *this };
-  for (const auto& pipeline : m_pipelineMap)
+  // Iterate by index as pipeline updates may add or remove pipelines
+  for (std::size_t iPipeline = 0; iPipeline < this->m_pipelines.Size(); ++iPipeline)
   {
-    this->UpdatePipeline(pipeline.second);
+    this->UpdatePipeline(this->m_pipelines[iPipeline].Pipeline);
   }
 }
 
 bool vtkMRMLLayerDMPipelineManager::RemovePipeline(vtkMRMLNode* displayNode)
 {
-  auto pipeline = this->GetNodePipeline(displayNode);
+  // Lookup by key as the node may have been deleted since its removal from the scene
+  vtkSmartPointer<vtkMRMLLayerDMPipelineI> pipeline = this->m_pipelines.FindByKey(displayNode);
   if (!pipeline)
   {
     return false;
   }
 
+  this->m_sceneRemovedNodes.erase(displayNode);
+  this->UnmarkPipelineDirty(pipeline);
+  this->CancelPipelineUpdate(pipeline);
+  this->m_updateStates.erase(pipeline);
   RequestRenderOnceGuard renderGuard{ *this };
   pipeline->SetFrozen(true);
   // Let interaction logic process the removal first if the pipeline needs to lose focus.
   this->m_interactionLogic->RemovePipeline(pipeline);
   this->m_layerManager->RemovePipeline(pipeline);
-  this->m_pipelineMap.erase(displayNode);
-  this->InvokeEvent(vtkCommand::ModifiedEvent);
+  this->m_pipelines.Erase(displayNode);
+  this->InvokePipelinesModified();
   return true;
 }
 
 void vtkMRMLLayerDMPipelineManager::SetRenderWindow(vtkRenderWindow* renderWindow)
 {
   // Observe window resize updates (bound to default camera changed update for representations which depend on the camera / display properties)
-  this->m_eventObs->UpdateObserver(this->m_renderWindow, renderWindow, vtkCommand::WindowResizeEvent);
+  // Observe render start to update the dirty pipelines right before the render
+  this->m_eventObs->UpdateObserver(this->m_renderWindow, renderWindow, { vtkCommand::WindowResizeEvent, vtkCommand::StartEvent });
   this->m_renderWindow = renderWindow;
   this->m_layerManager->SetRenderWindow(renderWindow);
 }
@@ -155,6 +308,7 @@ void vtkMRMLLayerDMPipelineManager::SetViewNode(vtkMRMLAbstractViewNode* viewNod
   this->m_viewNode = viewNode;
   this->m_cameraSync->SetViewNode(viewNode);
   this->m_interactionLogic->SetViewNode(viewNode);
+  this->m_isFullSceneUpdateRequested = true;
   this->UpdateAllPipelines();
 }
 
@@ -165,8 +319,9 @@ void vtkMRMLLayerDMPipelineManager::SetFactory(const vtkSmartPointer<vtkMRMLLaye
     return;
   }
 
-  this->m_eventObs->UpdateObserver(this->m_factory, factory);
+  this->m_eventObs->UpdateObserver(this->m_factory, factory, vtkMRMLLayerDMPipelineFactory::PipelineCreatorAddedEvent);
   this->m_factory = factory;
+  this->m_isFullSceneUpdateRequested = true;
   this->UpdateFromScene();
 }
 
@@ -176,6 +331,16 @@ int vtkMRMLLayerDMPipelineManager::GetMouseCursor() const
   return lastFocused ? lastFocused->GetMouseCursor() : VTK_CURSOR_DEFAULT;
 }
 
+vtkMRMLLayerDMPipelineI* vtkMRMLLayerDMPipelineManager::GetLastFocusedPipeline() const
+{
+  return this->m_interactionLogic->GetLastFocusedPipeline();
+}
+
+vtkMRMLLayerDMInteractionLatency* vtkMRMLLayerDMPipelineManager::GetInteractionLatency() const
+{
+  return this->m_interactionLatency;
+}
+
 bool vtkMRMLLayerDMPipelineManager::CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2) const
 {
   return this->m_interactionLogic->CanProcessInteractionEvent(eventData, distance2);
@@ -198,17 +363,94 @@ bool vtkMRMLLayerDMPipelineManager::ProcessInteractionEvent(vtkMRMLInteractionEv
 
 bool vtkMRMLLayerDMPipelineManager::RemoveNode(vtkMRMLNode* node)
 {
+  // A removed node added back to the scene needs to be processed again
+  if (node == this->m_lastAddedNode)
+  {
+    this->m_lastAddedNode = nullptr;
+  }
+
+  // Nodes removed before the end of the batch processing don't need their pipeline to be created
+  if (this->m_pendingNodeSet.erase(node))
+  {
+    this->m_pendingNodes.erase(std::remove(this->m_pendingNodes.begin(), this->m_pendingNodes.end(), node), this->m_pendingNodes.end());
+  }
+
   return this->RemovePipeline(node);
 }
 
 void vtkMRMLLayerDMPipelineManager::ResetCameraClippingRange() const
 {
+  vtkMRMLLayerDMTracer::Scope traceScope{ "ResetCameraClippingRange", "render" };
+  traceScope.SetView(this->m_viewNode);
+
+  // Slab clipping only applies to slice views
+  const auto sliceNode = vtkMRMLSliceNode::SafeDownCast(this->m_viewNode);
+  if (this->m_isSliceSlabClippingEnabled && sliceNode)
+  {
+    this->m_layerManager->SetClippingRangeMode(vtkMRMLLayerDMLayerManager::SlabClippingRange);
+    this->m_layerManager->SetSlabThickness(this->m_sliceSlabThickness > 0 ? this->m_sliceSlabThickness : sliceNode->GetFieldOfView()[2]);
+  }
+  else
+  {
+    this->m_layerManager->SetClippingRangeMode(vtkMRMLLayerDMLayerManager::VisiblePropBoundsClippingRange);
+  }
+
   // Block camera sync update triggers during clipping range refresh
   const auto wasBlocked = this->m_cameraSync->BlockModified(true);
   this->m_layerManager->ResetCameraClippingRange();
   this->m_cameraSync->BlockModified(wasBlocked);
 }
 
+void vtkMRMLLayerDMPipelineManager::SetSliceSlabClippingEnabled(bool isEnabled)
+{
+  if (this->m_isSliceSlabClippingEnabled == isEnabled)
+  {
+    return;
+  }
+  this->m_isSliceSlabClippingEnabled = isEnabled;
+  this->RequestRender();
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsSliceSlabClippingEnabled() const
+{
+  return this->m_isSliceSlabClippingEnabled;
+}
+
+void vtkMRMLLayerDMPipelineManager::SetSliceSlabThickness(double thickness)
+{
+  if (this->m_sliceSlabThickness == thickness)
+  {
+    return;
+  }
+  this->m_sliceSlabThickness = thickness;
+  this->RequestRender();
+}
+
+double vtkMRMLLayerDMPipelineManager::GetSliceSlabThickness() const
+{
+  return this->m_sliceSlabThickness;
+}
+
+void vtkMRMLLayerDMPipelineManager::SetSkipEmptyLayersDraw(bool isEnabled)
+{
+  if (this->m_layerManager->IsSkipEmptyLayersDrawEnabled() == isEnabled)
+  {
+    return;
+  }
+  this->m_layerManager->SetSkipEmptyLayersDraw(isEnabled);
+  this->RequestRender();
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsSkipEmptyLayersDrawEnabled() const
+{
+  return this->m_layerManager->IsSkipEmptyLayersDrawEnabled();
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfSkippedLayerDraws() const
+{
+  return this->m_layerManager->GetNumberOfSkippedLayerDraws();
+}
+
 void vtkMRMLLayerDMPipelineManager::RequestRender()
 {
   if (this->m_isRequestRenderBlocked || !this->m_renderWindow)
@@ -216,18 +458,443 @@ void vtkMRMLLayerDMPipelineManager::RequestRender()
     return;
   }
 
+  vtkMRMLLayerDMTracer::Scope traceScope{ "RequestRender", "render" };
+  traceScope.SetView(this->m_viewNode);
   this->BlockRequestRender(true);
   this->ResetCameraClippingRange();
+  this->m_interactionLogic->SetRenderPending(true);
+  this->m_interactionLatency->OnRenderRequested();
   this->m_requestRender();
   this->BlockRequestRender(false);
 }
 
+void vtkMRMLLayerDMPipelineManager::MarkPipelineDirty(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  if (!pipeline)
+  {
+    return;
+  }
+
+  if (!this->m_dirtyPipelineSet.insert(pipeline).second)
+  {
+    this->m_nCoalescedUpdates++;
+    return;
+  }
+
+  this->m_dirtyPipelines.emplace_back(pipeline);
+  this->RequestRender();
+}
+
+void vtkMRMLLayerDMPipelineManager::UpdatePipelineLayer(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  if (!pipeline)
+  {
+    return;
+  }
+
+  vtkMRMLLayerDMTracer::Scope traceScope{ "UpdatePipelineLayer", "layers" };
+  traceScope.SetPipeline(pipeline).SetNode(pipeline->GetDisplayNode()).SetView(this->m_viewNode);
+  this->m_layerManager->UpdatePipelineLayer(pipeline);
+  this->m_interactionLogic->UpdatePipelineCustomCamera(pipeline);
+  this->RequestRender();
+}
+
+void vtkMRMLLayerDMPipelineManager::UpdatePipelineInteractionBounds(vtkMRMLLayerDMPipelineI* pipeline) const
+{
+  this->m_interactionLogic->UpdatePipelineInteractionBounds(pipeline);
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfPolledPipelines() const
+{
+  return this->m_interactionLogic->GetNumberOfPolledPipelines();
+}
+
+void vtkMRMLLayerDMPipelineManager::SetMouseMoveCoalescing(bool isEnabled) const
+{
+  this->m_interactionLogic->SetMouseMoveCoalescing(isEnabled);
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsMouseMoveCoalescingEnabled() const
+{
+  return this->m_interactionLogic->IsMouseMoveCoalescingEnabled();
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfDroppedMouseMoves() const
+{
+  return this->m_interactionLogic->GetNumberOfDroppedMouseMoves();
+}
+
+void vtkMRMLLayerDMPipelineManager::ResetNumberOfDroppedMouseMoves() const
+{
+  this->m_interactionLogic->ResetNumberOfDroppedMouseMoves();
+}
+
+void vtkMRMLLayerDMPipelineManager::SetConcurrentPollingThreshold(int threshold) const
+{
+  this->m_interactionLogic->SetConcurrentPollingThreshold(threshold);
+}
+
+int vtkMRMLLayerDMPipelineManager::GetConcurrentPollingThreshold() const
+{
+  return this->m_interactionLogic->GetConcurrentPollingThreshold();
+}
+
+void vtkMRMLLayerDMPipelineManager::SetNumberOfPollingThreads(int nThreads) const
+{
+  this->m_interactionLogic->SetNumberOfPollingThreads(nThreads);
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfPollingThreads() const
+{
+  return this->m_interactionLogic->GetNumberOfPollingThreads();
+}
+
+void vtkMRMLLayerDMPipelineManager::UnmarkPipelineDirty(const vtkMRMLLayerDMPipelineI* pipeline)
+{
+  // Pipeline is kept in the dirty queue and skipped during the reset
+  this->m_dirtyPipelineSet.erase(pipeline);
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsPipelineDirty(const vtkMRMLLayerDMPipelineI* pipeline) const
+{
+  return this->m_dirtyPipelineSet.count(pipeline) > 0;
+}
+
+void vtkMRMLLayerDMPipelineManager::FlushDirtyPipelines()
+{
+  RequestRenderOnceGuard renderGuard{ *this };
+  this->ResetDirtyPipelinesDisplay();
+}
+
+int vtkMRMLLayerDMPipelineManager::ResetDirtyPipelinesDisplay()
+{
+  if (this->m_dirtyPipelineSet.empty())
+  {
+    this->m_dirtyPipelines.clear();
+    return 0;
+  }
+
+  // Pipelines marked dirty during the reset are processed on next render
+  const auto dirtyPipelines = std::move(this->m_dirtyPipelines);
+  this->m_dirtyPipelines.clear();
+
+  int nReset = 0;
+  const auto wasBlocked = this->BlockRequestRender(true);
+  for (const auto& pipeline : dirtyPipelines)
+  {
+    if (!pipeline || !this->m_dirtyPipelineSet.erase(pipeline))
+    {
+      continue;
+    }
+
+    pipeline->ResetDisplayNow();
+    nReset++;
+  }
+  this->BlockRequestRender(wasBlocked);
+
+  this->m_nFlushedUpdates += nReset;
+  return nReset;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfDirtyPipelines() const
+{
+  return static_cast<int>(this->m_dirtyPipelineSet.size());
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfCoalescedUpdates() const
+{
+  return this->m_nCoalescedUpdates;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfFlushedUpdates() const
+{
+  return this->m_nFlushedUpdates;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfPendingUpdates() const
+{
+  return this->m_nPendingUpdates;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfCommittedUpdates() const
+{
+  return this->m_nCommittedUpdates;
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfCancelledUpdates() const
+{
+  return this->m_nCancelledUpdates;
+}
+
+void vtkMRMLLayerDMPipelineManager::ResetUpdateCounters()
+{
+  this->m_nCoalescedUpdates = 0;
+  this->m_nFlushedUpdates = 0;
+  this->m_nCommittedUpdates = 0;
+  this->m_nCancelledUpdates = 0;
+}
+
+void vtkMRMLLayerDMPipelineManager::SetPerformanceCountersEnabled(bool isEnabled)
+{
+  this->m_isPerformanceCountersEnabled = isEnabled;
+  for (const auto& entry : this->m_pipelines)
+  {
+    entry.Pipeline->SetPerformanceCountersEnabled(isEnabled);
+  }
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsPerformanceCountersEnabled() const
+{
+  return this->m_isPerformanceCountersEnabled;
+}
+
+void vtkMRMLLayerDMPipelineManager::ResetPerformanceCounters()
+{
+  for (const auto& entry : this->m_pipelines)
+  {
+    entry.Pipeline->ResetPerformanceCounters();
+  }
+}
+
+std::string vtkMRMLLayerDMPipelineManager::GetPerformanceReport() const
+{
+  struct ReportLine
+  {
+    double TotalTime;
+    std::string Text;
+  };
+
+  std::vector<ReportLine> lines;
+  for (const auto& entry : this->m_pipelines)
+  {
+    const auto& pipeline = entry.Pipeline;
+    const char* nodeId = entry.Node && entry.Node->GetID() ? entry.Node->GetID() : "";
+    for (int iDispatch = 0; iDispatch < vtkMRMLLayerDMPipelineI::NumberOfDispatchPoints; iDispatch++)
+    {
+      const auto callCount = pipeline->GetCallCount(iDispatch);
+      if (callCount == 0)
+      {
+        continue;
+      }
+
+      std::ostringstream line;
+      line << pipeline->GetClassName() << " (" << nodeId << ") " << vtkMRMLLayerDMPipelineI::GetDispatchPointName(iDispatch) << ": calls=" << callCount
+           << " total=" << 1000. * pipeline->GetTotalTime(iDispatch) << "ms max=" << 1000. * pipeline->GetMaxTime(iDispatch) << "ms";
+      lines.push_back({ pipeline->GetTotalTime(iDispatch), line.str() });
+    }
+  }
+
+  std::sort(lines.begin(), lines.end(), [](const ReportLine& a, const ReportLine& b) { return a.TotalTime > b.TotalTime; });
+
+  std::string report;
+  for (const auto& line : lines)
+  {
+    report += line.Text + "\n";
+  }
+  return report;
+}
+
+void vtkMRMLLayerDMPipelineManager::SchedulePipelineUpdate(vtkMRMLLayerDMPipelineI* pipeline)
+{
+  if (!pipeline)
+  {
+    return;
+  }
+
+  auto& state = this->m_updateStates[pipeline];
+  if (!state.Generation)
+  {
+    state.Generation = std::make_shared<std::atomic<std::uint64_t>>(0);
+  }
+
+  // Incrementing the generation cancels the previous update of the pipeline
+  const auto generation = ++(*state.Generation);
+  state.IsPending = true;
+
+  if (!this->m_updatePool)
+  {
+    this->m_updatePool = std::make_unique<layer_dm::WorkStealingThreadPool>(this->m_nUpdateThreads);
+  }
+
+  AsyncUpdateResult task{ pipeline, generation, pipeline->CreateUpdateSnapshot(), nullptr, true };
+  this->m_nPendingUpdates++;
+  this->m_updatePool->Submit(
+    [queue = this->m_completedUpdates, currentGeneration = state.Generation, result = std::move(task)]() mutable
+    {
+      // Stale updates are not prepared
+      if (currentGeneration->load() == result.Generation)
+      {
+        result.PreparedData = result.Pipeline->PrepareUpdate(result.Snapshot);
+        result.IsCancelled = currentGeneration->load() != result.Generation;
+      }
+
+      // VTK objects are moved to the queue to be released on the main thread
+      std::lock_guard<std::mutex> lock(queue->Mutex);
+      queue->Completed.emplace_back(std::move(result));
+      queue->HasCompleted = true;
+    });
+
+  // Without interactor timer, the render StartEvent commits the prepared updates
+  if (!this->StartCommitTimer())
+  {
+    this->RequestRender();
+  }
+}
+
+void vtkMRMLLayerDMPipelineManager::CancelPipelineUpdate(const vtkMRMLLayerDMPipelineI* pipeline)
+{
+  auto found = this->m_updateStates.find(pipeline);
+  if (found == this->m_updateStates.end() || !found->second.IsPending)
+  {
+    return;
+  }
+
+  ++(*found->second.Generation);
+  found->second.IsPending = false;
+}
+
+bool vtkMRMLLayerDMPipelineManager::IsPipelineUpdatePending(const vtkMRMLLayerDMPipelineI* pipeline) const
+{
+  auto found = this->m_updateStates.find(pipeline);
+  return found != this->m_updateStates.end() && found->second.IsPending;
+}
+
+int vtkMRMLLayerDMPipelineManager::ProcessCompletedPipelineUpdates()
+{
+  std::vector<AsyncUpdateResult> completed;
+  {
+    std::lock_guard<std::mutex> lock(this->m_completedUpdates->Mutex);
+    std::swap(completed, this->m_completedUpdates->Completed);
+    this->m_completedUpdates->HasCompleted = false;
+  }
+
+  if (completed.empty())
+  {
+    return 0;
+  }
+
+  int nCommitted = 0;
+  const auto wasBlocked = this->BlockRequestRender(true);
+  for (const auto& result : completed)
+  {
+    this->m_nPendingUpdates--;
+    auto found = this->m_updateStates.find(result.Pipeline);
+    const bool isCurrent = found != this->m_updateStates.end() && found->second.Generation->load() == result.Generation;
+    if (result.IsCancelled || !isCurrent || result.Pipeline->IsFrozen())
+    {
+      this->m_nCancelledUpdates++;
+      continue;
+    }
+
+    found->second.IsPending = false;
+    if (result.PreparedData)
+    {
+      result.Pipeline->CommitUpdate(result.PreparedData);
+      nCommitted++;
+    }
+  }
+  this->m_nCommittedUpdates += nCommitted;
+  this->BlockRequestRender(wasBlocked);
+
+  if (this->m_nPendingUpdates == 0)
+  {
+    this->StopCommitTimer();
+  }
+
+  // Only request render if the pipelines have changed
+  if (nCommitted > 0)
+  {
+    this->RequestRender();
+  }
+  return nCommitted;
+}
+
+void vtkMRMLLayerDMPipelineManager::PollCompletedPipelineUpdates()
+{
+  // The commit timer already processes the completed updates
+  if (this->m_commitTimerId < 0 && this->m_completedUpdates->HasCompleted)
+  {
+    this->ProcessCompletedPipelineUpdates();
+  }
+}
+
+void vtkMRMLLayerDMPipelineManager::WaitForPipelineUpdates()
+{
+  if (this->m_updatePool)
+  {
+    this->m_updatePool->WaitIdle();
+  }
+  this->ProcessCompletedPipelineUpdates();
+}
+
+void vtkMRMLLayerDMPipelineManager::SetNumberOfUpdateThreads(int nThreads)
+{
+  nThreads = std::max(1, nThreads);
+  if (this->m_nUpdateThreads == nThreads)
+  {
+    return;
+  }
+
+  this->WaitForPipelineUpdates();
+  this->m_nUpdateThreads = nThreads;
+  this->m_updatePool.reset();
+}
+
+int vtkMRMLLayerDMPipelineManager::GetNumberOfUpdateThreads() const
+{
+  return this->m_nUpdateThreads;
+}
+
+bool vtkMRMLLayerDMPipelineManager::StartCommitTimer()
+{
+  if (this->m_commitTimerId >= 0)
+  {
+    return true;
+  }
+
+  if (!this->m_renderWindow || !this->m_renderWindow->GetInteractor())
+  {
+    return false;
+  }
+
+  this->m_commitInteractor = this->m_renderWindow->GetInteractor();
+  this->m_eventObs->UpdateObserver(nullptr, this->m_commitInteractor, vtkCommand::TimerEvent);
+  this->m_commitTimerId = this->m_commitInteractor->CreateRepeatingTimer(CommitTimerPeriodMs);
+  if (this->m_commitTimerId < 0)
+  {
+    this->m_eventObs->RemoveObserver(this->m_commitInteractor);
+    this->m_commitInteractor = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void vtkMRMLLayerDMPipelineManager::StopCommitTimer()
+{
+  if (this->m_commitTimerId < 0)
+  {
+    return;
+  }
+
+  if (this->m_commitInteractor)
+  {
+    this->m_commitInteractor->DestroyTimer(this->m_commitTimerId);
+    this->m_eventObs->RemoveObserver(this->m_commitInteractor);
+  }
+  this->m_commitInteractor = nullptr;
+  this->m_commitTimerId = -1;
+}
+
 void vtkMRMLLayerDMPipelineManager::OnDefaultCameraModified()
 {
   RequestRenderOnceGuard renderGuard{ *this };
-  for (const auto& pipeline : this->m_pipelineMap)
+  for (std::size_t iPipeline = 0; iPipeline < this->m_pipelines.Size(); ++iPipeline)
   {
-    pipeline.second->OnDefaultCameraModified(this->m_defaultCamera);
+    const auto& pipeline = this->m_pipelines[iPipeline].Pipeline;
+    vtkMRMLLayerDMTracer::Scope traceScope{ "OnDefaultCameraModified", "camera" };
+    traceScope.SetNode(this->m_pipelines[iPipeline].Node).SetPipeline(pipeline).SetView(this->m_viewNode);
+    vtkMRMLLayerDMPipelineI::PerformanceCounterGuard counterGuard{ pipeline, vtkMRMLLayerDMPipelineI::OnDefaultCameraModifiedDispatch };
+    pipeline->OnDefaultCameraModified(this->m_defaultCamera);
   }
 }
 
@@ -236,13 +903,17 @@ vtkMRMLLayerDMPipelineManager::vtkMRMLLayerDMPipelineManager()
   , m_layerManager(vtkSmartPointer<vtkMRMLLayerDMLayerManager>::New())
   , m_cameraSync(vtkSmartPointer<vtkMRMLLayerDMCameraSynchronizer>::New())
   , m_interactionLogic(vtkSmartPointer<vtkMRMLLayerDMInteractionLogic>::New())
+  , m_interactionLatency(vtkSmartPointer<vtkMRMLLayerDMInteractionLatency>::New())
   , m_eventObs(vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver>::New())
+  , m_sceneObs(vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver>::New())
   , m_defaultCamera(vtkSmartPointer<vtkCamera>::New())
   , m_nodeRefObs{ vtkSmartPointer<vtkMRMLLayerDMNodeReferenceObserver>::New() }
   , m_viewNode{ nullptr }
   , m_scene{ nullptr }
-  , m_pipelineMap{}
+  , m_pipelines{}
   , m_requestRender{ [] {} }
+  , m_completedUpdates{ std::make_shared<AsyncUpdateQueue>() }
+  , m_nUpdateThreads{ static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2)) }
 {
   this->m_cameraSync->SetDefaultCamera(this->m_defaultCamera);
   this->m_layerManager->SetDefaultCamera(this->m_defaultCamera);
@@ -266,11 +937,38 @@ vtkMRMLLayerDMPipelineManager::vtkMRMLLayerDMPipelineManager()
     });
 
   this->m_eventObs->SetUpdateCallback(
-    [this](vtkObject* obj)
+    [this](vtkObject* obj, unsigned long eventId, void* callData)
     {
-      if (obj == this->m_factory)
+      if (obj == this->m_factory && eventId == vtkMRMLLayerDMPipelineFactory::PipelineCreatorAddedEvent)
       {
-        this->UpdateFromScene();
+        this->CreatePipelinesForCreator(static_cast<vtkMRMLLayerDMPipelineCreatorI*>(callData));
+      }
+
+      if (obj == this->m_renderWindow && eventId == vtkCommand::StartEvent)
+      {
+        // Forward the coalesced mouse move, update the dirty pipelines and commit the prepared updates before they
+        // are rendered
+        this->m_interactionLatency->OnRenderStarted();
+        this->m_interactionLogic->SetRenderPending(false);
+        const bool wasBlocked = this->BlockRequestRender(true);
+        const bool didProcessMouseMove = this->m_interactionLogic->FlushCoalescedMouseMove();
+        const auto nCommitted = this->ProcessCompletedPipelineUpdates();
+        this->BlockRequestRender(wasBlocked);
+        if (this->ResetDirtyPipelinesDisplay() + nCommitted > 0 || didProcessMouseMove)
+        {
+          this->ResetCameraClippingRange();
+        }
+        this->m_layerManager->UpdateRendererDrawStates();
+        return;
+      }
+
+      if (eventId == vtkCommand::TimerEvent)
+      {
+        if (callData && *static_cast<int*>(callData) == this->m_commitTimerId)
+        {
+          this->ProcessCompletedPipelineUpdates();
+        }
+        return;
       }
 
       if (obj == this->m_cameraSync || obj == this->m_renderWindow)
@@ -279,10 +977,33 @@ vtkMRMLLayerDMPipelineManager::vtkMRMLLayerDMPipelineManager()
       }
     });
 
+  this->m_sceneObs->SetUpdateCallback(
+    [this](vtkObject*, unsigned long eventId, void* callData)
+    {
+      this->PollCompletedPipelineUpdates();
+      auto node = reinterpret_cast<vtkMRMLNode*>(callData);
+      if (eventId == vtkMRMLScene::NodeAddedEvent)
+      {
+        this->OnSceneNodeAdded(node);
+      }
+      else if (eventId == vtkMRMLScene::NodeRemovedEvent)
+      {
+        this->OnSceneNodeRemoved(node);
+      }
+    });
+
   // Monitor camera updates
   this->m_eventObs->UpdateObserver(nullptr, this->m_cameraSync);
 }
 
+vtkMRMLLayerDMPipelineManager::~vtkMRMLLayerDMPipelineManager()
+{
+  this->StopCommitTimer();
+
+  // Discard the queued updates (released on this thread) and wait for the running ones
+  this->m_updatePool.reset();
+}
+
 void vtkMRMLLayerDMPipelineManager::UpdatePipeline(const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline) const
 {
   if (!pipeline)
@@ -296,27 +1017,22 @@ void vtkMRMLLayerDMPipelineManager::UpdatePipeline(const vtkSmartPointer<vtkMRML
 
 vtkSmartPointer<vtkMRMLLayerDMPipelineI> vtkMRMLLayerDMPipelineManager::GetNodePipeline(vtkMRMLNode* node) const
 {
-  const auto found = this->m_pipelineMap.find(node);
-  if (found == std::end(this->m_pipelineMap))
-  {
-    return {};
-  }
-  return found->second;
+  return this->m_pipelines.Find(node);
 }
 
 int vtkMRMLLayerDMPipelineManager::GetNumberOfPipelines() const
 {
-  return this->m_pipelineMap.size();
+  return static_cast<int>(this->m_pipelines.Size());
 }
 
 vtkMRMLLayerDMPipelineI* vtkMRMLLayerDMPipelineManager::GetNthPipeline(int iPipeline) const
 {
-  if (iPipeline < 0 || iPipeline >= this->m_pipelineMap.size())
+  if (iPipeline < 0 || iPipeline >= this->GetNumberOfPipelines())
   {
     return nullptr;
   }
 
-  return std::next(this->m_pipelineMap.begin(), iPipeline)->second;
+  return this->m_pipelines[iPipeline].Pipeline;
 }
 
 void vtkMRMLLayerDMPipelineManager::SetRenderer(vtkRenderer* renderer) const
@@ -343,18 +1059,19 @@ void vtkMRMLLayerDMPipelineManager::RemoveOutdatedPipelines()
     return;
   }
 
-  std::vector<vtkWeakPointer<vtkMRMLNode>> outdatedPipelines;
-  for (const auto& pipe : m_pipelineMap)
+  // Store the registry keys as deleted nodes can only be removed using their registration key
+  std::vector<vtkMRMLNode*> outdatedPipelines;
+  for (const auto& entry : this->m_pipelines)
   {
-    if (!pipe.first || !this->m_scene->GetNodeByID(pipe.first->GetID()))
+    if (!entry.Node || !this->m_scene->GetNodeByID(entry.Node->GetID()))
     {
-      outdatedPipelines.emplace_back(pipe.first);
+      outdatedPipelines.emplace_back(entry.Key);
     }
   }
 
-  for (const auto& pipe : outdatedPipelines)
+  for (const auto& key : outdatedPipelines)
   {
-    this->RemovePipeline(pipe);
+    this->RemovePipeline(key);
   }
 }
 
@@ -383,10 +1100,112 @@ void vtkMRMLLayerDMPipelineManager::UpdateFromScene()
   }
 
   RequestRenderOnceGuard renderGuard{ *this };
+  if (!this->m_isFullSceneUpdateRequested)
+  {
+    this->ProcessPendingSceneChanges();
+    return;
+  }
+
+  this->m_isFullSceneUpdateRequested = false;
+  this->m_sceneAddedNodes.clear();
+  this->m_sceneRemovedNodes.clear();
   this->RemoveOutdatedPipelines();
   this->AddMissingPipelines();
 }
 
+int vtkMRMLLayerDMPipelineManager::GetNumberOfPendingSceneChanges() const
+{
+  return static_cast<int>(this->m_sceneAddedNodes.size() + this->m_sceneRemovedNodes.size());
+}
+
+void vtkMRMLLayerDMPipelineManager::OnSceneNodeAdded(vtkMRMLNode* node)
+{
+  // Node may have been removed and added back before the update
+  this->m_sceneRemovedNodes.erase(node);
+
+  // The displayable manager scene observer runs first and already processed the node
+  const bool wasProcessed = node && node == this->m_lastAddedNode;
+  this->m_lastAddedNode = nullptr;
+  if (node && !wasProcessed && !this->m_pipelines.Contains(node))
+  {
+    this->m_sceneAddedNodes[node] = node;
+  }
+}
+
+void vtkMRMLLayerDMPipelineManager::OnSceneNodeRemoved(vtkMRMLNode* node)
+{
+  this->m_sceneAddedNodes.erase(node);
+  if (node == this->m_lastAddedNode)
+  {
+    this->m_lastAddedNode = nullptr;
+  }
+  if (this->m_pipelines.Contains(node))
+  {
+    this->m_sceneRemovedNodes.insert(node);
+  }
+}
+
+void vtkMRMLLayerDMPipelineManager::ProcessPendingSceneChanges()
+{
+  // Move the pending changes as processing them may trigger new scene changes
+  const auto removedNodes = std::move(this->m_sceneRemovedNodes);
+  const auto addedNodes = std::move(this->m_sceneAddedNodes);
+  this->m_sceneRemovedNodes.clear();
+  this->m_sceneAddedNodes.clear();
+
+  for (const auto& key : removedNodes)
+  {
+    this->RemovePipeline(key);
+  }
+
+  for (const auto& pair : addedNodes)
+  {
+    if (pair.second)
+    {
+      this->AddNode(pair.second);
+    }
+  }
+}
+
+void vtkMRMLLayerDMPipelineManager::CreatePipelinesForCreator(vtkMRMLLayerDMPipelineCreatorI* creator)
+{
+  if (!this->m_scene || !this->m_factory || !this->m_viewNode || !creator)
+  {
+    return;
+  }
+
+  // Scene will be fully processed on next update
+  if (this->m_isFullSceneUpdateRequested)
+  {
+    this->UpdateFromScene();
+    return;
+  }
+
+  RequestRenderOnceGuard renderGuard{ *this };
+  int nNodes = this->m_scene->GetNumberOfNodes();
+  for (int iNode = 0; iNode < nNodes; iNode++)
+  {
+    auto node = vtkMRMLNode::SafeDownCast(this->m_scene->GetNodes()->GetItemAsObject(iNode));
+    if (!node || this->m_pipelines.Contains(node))
+    {
+      continue;
+    }
+
+    // Let the batch processing create the pipeline using the full factory at the end of the batch
+    if (this->m_isBatchProcessing)
+    {
+      this->AddNode(node);
+      continue;
+    }
+
+    if (auto pipeline = this->m_factory->CreatePipelineWithCreator(creator, this->m_viewNode, node))
+    {
+      this->m_sceneAddedNodes.erase(node);
+      this->AddCreatedPipeline(node, pipeline);
+    }
+  }
+}
+
 bool vtkMRMLLayerDMPipelineManager::BlockRequestRender(bool isBlocked)
 {
   const auto wasBlocked = this->m_isRequestRenderBlocked;
@@ -401,10 +1220,14 @@ void vtkMRMLLayerDMPipelineManager::SetScene(vtkMRMLScene* scene)
     return;
   }
 
+  this->m_sceneObs->UpdateObserver(this->m_scene, scene, { vtkMRMLScene::NodeAddedEvent, vtkMRMLScene::NodeRemovedEvent });
   this->m_scene = scene;
+  this->m_isFullSceneUpdateRequested = true;
+  this->m_sceneAddedNodes.clear();
+  this->m_sceneRemovedNodes.clear();
   this->m_nodeRefObs->SetScene(scene);
-  for (const auto& [node, pipeline] : m_pipelineMap)
+  for (const auto& entry : this->m_pipelines)
   {
-    pipeline->SetScene(scene);
+    entry.Pipeline->SetScene(scene);
   }
 }
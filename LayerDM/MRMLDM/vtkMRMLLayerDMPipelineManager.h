@@ -2,6 +2,10 @@
 
 #include "vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h"
 
+// Layer DM includes
+#include "vtkMRMLLayerDMPipelineRegistry.h"
+#include "vtkMRMLLayerDMThreadPool.h"
+
 // VTK includes
 #include <vtkCommand.h>
 #include <vtkObject.h>
@@ -9,13 +13,22 @@
 #include <vtkWeakPointer.h>
 
 // STL includes
+#include <atomic>
+#include <cstdint>
 #include <functional>
-#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class vtkCamera;
 class vtkMRMLAbstractViewNode;
 class vtkMRMLInteractionEventData;
 class vtkMRMLLayerDMCameraSynchronizer;
+class vtkMRMLLayerDMInteractionLatency;
 class vtkMRMLLayerDMInteractionLogic;
 class vtkMRMLLayerDMLayerManager;
 class vtkMRMLLayerDMNodeReferenceObserver;
@@ -26,6 +39,7 @@ class vtkMRMLLayerDMPipelineI;
 class vtkMRMLNode;
 class vtkMRMLScene;
 class vtkRenderWindow;
+class vtkRenderWindowInteractor;
 class vtkRenderer;
 
 /// \brief Class responsible for handling adding / updating / removing pipelines depending on nodes added / removed /
@@ -41,8 +55,24 @@ public:
   /// Add a new node to the pipeline manager.
   /// If no pipeline exist for the input display node and the \sa vtkMRMLLayerDMPipelineFactory can create
   /// a pipeline, creates and stores the pipeline in the manager.
+  ///
+  /// During batch processing, the node is queued and false is returned.
+  /// Its pipeline creation is deferred to \sa EndBatchProcess.
   bool AddNode(vtkMRMLNode* node);
 
+  /// @{
+  /// Start / end batch processing (for instance during scene loading or scene close).
+  /// While batch processing, added nodes are queued and their pipelines are created in a single pass on
+  /// \sa EndBatchProcess with a single layer update, a single render request and a single ModifiedEvent.
+  /// Removed nodes are removed from the queue or their pipelines are removed without updating the layers.
+  void StartBatchProcess();
+  void EndBatchProcess();
+  bool IsBatchProcessing() const;
+  /// @}
+
+  /// Returns the number of nodes queued for pipeline creation during the current batch processing.
+  int GetNumberOfPendingNodes() const;
+
   /// Delegates can process interaction event to \sa vtkMRMLLayerDMInteractionLogic
   bool CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2) const;
 
@@ -61,13 +91,22 @@ public:
   /// Returns the mouse cursor from the latest pipeline having handled the latest interaction.
   int GetMouseCursor() const;
 
+  /// Returns the latest pipeline having handled the latest interaction if it still has the focus.
+  vtkMRMLLayerDMPipelineI* GetLastFocusedPipeline() const;
+
+  /// Returns the interaction latency histograms of the view (recording disabled by default).
+  /// Render requests and render starts are forwarded to it by the pipeline manager.
+  /// \sa vtkMRMLLayerDisplayableManager::CanProcessInteractionEvent
+  vtkMRMLLayerDMInteractionLatency* GetInteractionLatency() const;
+
   /// Returns the pipeline associated with the input display node if any.
   vtkSmartPointer<vtkMRMLLayerDMPipelineI> GetNodePipeline(vtkMRMLNode* node) const;
 
   /// Returns the number of pipelines currently managed by the pipeline manager
   int GetNumberOfPipelines() const;
 
-  /// Returns the list of currently managed display nodes of the pipeline manager.
+  /// Returns the Nth pipeline currently managed by the pipeline manager (O(1) access).
+  /// The pipeline ordering is unspecified and may change when pipelines are removed.
   ///
   /// \sa GetNodePipeline
   vtkMRMLLayerDMPipelineI* GetNthPipeline(int iPipeline) const;
@@ -90,12 +129,151 @@ public:
   /// Reset camera clipping range and call display manager request render.
   void RequestRender();
 
+  /// @{
+  /// Mark / unmark the input pipeline as needing a reset display.
+  /// Dirty pipelines are reset once right before the next render of the render window (render window StartEvent).
+  /// Marking an already dirty pipeline is counted as a coalesced update.
+  /// \sa vtkMRMLLayerDMPipelineI::SetDeferredResetDisplay
+  void MarkPipelineDirty(vtkMRMLLayerDMPipelineI* pipeline);
+  void UnmarkPipelineDirty(const vtkMRMLLayerDMPipelineI* pipeline);
+  bool IsPipelineDirty(const vtkMRMLLayerDMPipelineI* pipeline) const;
+  /// @}
+
+  /// Move the input pipeline to the layer matching its current render order and custom camera and request a render.
+  /// \sa vtkMRMLLayerDMPipelineI::RenderOrderChanged
+  void UpdatePipelineLayer(vtkMRMLLayerDMPipelineI* pipeline);
+
+  /// Update the interaction candidate selection with the current interaction bounds of the input pipeline.
+  /// \sa vtkMRMLLayerDMPipelineI::SetWorldInteractionBounds
+  void UpdatePipelineInteractionBounds(vtkMRMLLayerDMPipelineI* pipeline) const;
+
+  /// Returns the number of pipelines whose \sa vtkMRMLLayerDMPipelineI::CanProcessInteractionEvent was called for the
+  /// last interaction event.
+  int GetNumberOfPolledPipelines() const;
+
+  /// @{
+  /// Enable / disable the coalescing of the mouse moves arriving while a render is pending (default = false).
+  /// The latest coalesced move is forwarded to the pipelines when the render window starts rendering.
+  /// \sa vtkMRMLLayerDMInteractionLogic::SetMouseMoveCoalescing
+  void SetMouseMoveCoalescing(bool isEnabled) const;
+  bool IsMouseMoveCoalescingEnabled() const;
+  int GetNumberOfDroppedMouseMoves() const;
+  void ResetNumberOfDroppedMouseMoves() const;
+  /// @}
+
+  /// @{
+  /// Concurrent polling of the pipelines declaring a reentrant CanProcessInteractionEvent.
+  /// \sa vtkMRMLLayerDMInteractionLogic::SetConcurrentPollingThreshold
+  /// \sa vtkMRMLLayerDMPipelineI::SetReentrantCanProcessInteractionEvent
+  void SetConcurrentPollingThreshold(int threshold) const;
+  int GetConcurrentPollingThreshold() const;
+  void SetNumberOfPollingThreads(int nThreads) const;
+  int GetNumberOfPollingThreads() const;
+  /// @}
+
+  /// Synchronously reset the display of all the dirty pipelines and request a render.
+  void FlushDirtyPipelines();
+
+  /// @{
+  /// Schedule / cancel a two-phase update of the input pipeline.
+  /// The update snapshot is created immediately and prepared on the update worker threads.
+  /// Scheduling a new update for a pipeline cancels its previous update if not yet committed.
+  ///
+  /// Prepared updates are committed on the main thread, on the render window interactor timer, right before the next render
+  /// or when calling \sa ProcessCompletedPipelineUpdates.
+  /// Without render window interactor (offscreen / headless views), scheduling requests a render whose StartEvent commits
+  /// the updates prepared by then. The updates prepared later are committed by \sa PollCompletedPipelineUpdates.
+  /// \sa vtkMRMLLayerDMPipelineI::SetAsynchronousUpdate
+  void SchedulePipelineUpdate(vtkMRMLLayerDMPipelineI* pipeline);
+  void CancelPipelineUpdate(const vtkMRMLLayerDMPipelineI* pipeline);
+  bool IsPipelineUpdatePending(const vtkMRMLLayerDMPipelineI* pipeline) const;
+  /// @}
+
+  /// Commit the prepared updates and request a render if any update was committed (main thread).
+  /// Returns the number of committed updates.
+  int ProcessCompletedPipelineUpdates();
+
+  /// Commit the prepared updates if no commit timer is running and updates completed since the last commit (main thread).
+  /// Only checks an atomic flag when no update completed. Called on the scene events, hosts without render window
+  /// interactor can call it from their own event loop.
+  void PollCompletedPipelineUpdates();
+
+  /// Synchronously wait for all the scheduled updates to be prepared and commit them.
+  void WaitForPipelineUpdates();
+
+  /// @{
+  /// Number of worker threads used to prepare the updates.
+  /// Default is half the hardware concurrency (at least 1). Changing the number of threads waits for the scheduled updates.
+  void SetNumberOfUpdateThreads(int nThreads);
+  int GetNumberOfUpdateThreads() const;
+  /// @}
+
+  /// @{
+  /// Deferred reset display counters.
+  /// Coalesced updates are the reset display requests merged in an already pending update.
+  /// Flushed updates are the deferred reset displays actually executed.
+  int GetNumberOfDirtyPipelines() const;
+  int GetNumberOfCoalescedUpdates() const;
+  int GetNumberOfFlushedUpdates() const;
+  /// @}
+
+  /// @{
+  /// Asynchronous update counters.
+  /// Pending updates are scheduled and not yet committed or cancelled.
+  /// Cancelled updates have been superseded by a newer update or their pipeline was removed before commit.
+  int GetNumberOfPendingUpdates() const;
+  int GetNumberOfCommittedUpdates() const;
+  int GetNumberOfCancelledUpdates() const;
+  /// @}
+
+  /// Reset the deferred and asynchronous update counters.
+  void ResetUpdateCounters();
+
+  /// @{
+  /// Enable / disable the performance counters of the managed pipelines (disabled by default).
+  /// Pipelines added while enabled are enabled on creation.
+  /// \sa vtkMRMLLayerDMPipelineI::GetCallCount \sa vtkMRMLLayerDMPipelineI::GetTotalTime \sa vtkMRMLLayerDMPipelineI::GetMaxTime
+  void SetPerformanceCountersEnabled(bool isEnabled);
+  bool IsPerformanceCountersEnabled() const;
+  /// @}
+
+  /// Reset the performance counters of all the managed pipelines.
+  void ResetPerformanceCounters();
+
+  /// Returns a text report of the managed pipelines performance counters.
+  /// One line per pipeline and measured dispatch point with the pipeline class, its node ID, the call count and the
+  /// total / max times in ms. Lines are sorted by decreasing total time.
+  std::string GetPerformanceReport() const;
+
   /// Resets the clipping range for all cameras managed by the LayerDM and renderer 0's
   /// camera
   void ResetCameraClippingRange() const;
 
+  /// @{
+  /// Analytic clipping range of the slice views (disabled by default).
+  /// When enabled in a slice view, the clipping range of the layers using the default camera is a slab centered on the
+  /// slice plane instead of being computed from the visible prop bounds of the layers.
+  /// If the slab thickness is not positive (default), the slice thickness (slice node field of view along Z) is used.
+  /// \sa vtkMRMLLayerDMLayerManager::SlabClippingRange
+  void SetSliceSlabClippingEnabled(bool isEnabled);
+  bool IsSliceSlabClippingEnabled() const;
+  void SetSliceSlabThickness(double thickness);
+  double GetSliceSlabThickness() const;
+  /// @}
+
+  /// @{
+  /// Skip the drawing of the layers without visible props (enabled by default).
+  /// The layers drawing states are updated before each render of the render window.
+  /// \sa vtkMRMLLayerDMLayerManager::SetSkipEmptyLayersDraw
+  void SetSkipEmptyLayersDraw(bool isEnabled);
+  bool IsSkipEmptyLayersDrawEnabled() const;
+  /// @}
+
+  /// Returns the number of layers whose drawing was skipped during the last render.
+  int GetNumberOfSkippedLayerDraws() const;
+
   /// Set the Pipeline factory to use by the pipeline manager (initialization).
-  /// On factory-modified event, will trigger a \sa UpdateFromScene.
+  /// When a creator is added to the factory, only the new creator is probed for the scene nodes without pipeline.
   void SetFactory(const vtkSmartPointer<vtkMRMLLayerDMPipelineFactory>& factory);
 
   /// Set the render window on which the pipeline manager is attached (initialization).
@@ -108,6 +286,7 @@ public:
   void SetRequestRender(const std::function<void()>& requestRender);
 
   /// Set the scene (initialization).
+  /// The scene node added / removed events are tracked to allow incremental \sa UpdateFromScene.
   void SetScene(vtkMRMLScene* scene);
 
   /// Set the view node (initialization).
@@ -120,8 +299,14 @@ public:
   /// Update the pipeline manager from the current MRML scene state.
   /// Will automatically remove or create pipelines depending on the scene state.
   /// Requests render at the end of the update
+  ///
+  /// Only the nodes added to / removed from the scene since the last update are processed.
+  /// The whole scene is processed only after the scene, view node or factory have been changed.
   void UpdateFromScene();
 
+  /// Returns the number of scene node additions / removals not yet processed by \sa UpdateFromScene.
+  int GetNumberOfPendingSceneChanges() const;
+
   /// Block the request render
   /// Returns the previous blocked value.
   ///
@@ -131,15 +316,76 @@ public:
 
 protected:
   vtkMRMLLayerDMPipelineManager();
-  ~vtkMRMLLayerDMPipelineManager() override = default;
+  ~vtkMRMLLayerDMPipelineManager() override;
 
 private:
   /// Notify pipelines that the default camera has changed.
   void OnDefaultCameraModified();
 
+  /// Result of an asynchronous update, released on the main thread.
+  struct AsyncUpdateResult
+  {
+    vtkSmartPointer<vtkMRMLLayerDMPipelineI> Pipeline;
+    std::uint64_t Generation{};
+    vtkSmartPointer<vtkObject> Snapshot;
+    vtkSmartPointer<vtkObject> PreparedData;
+    bool IsCancelled{};
+  };
+
+  /// Per pipeline update generation (shared with the worker threads for stale update cancellation).
+  struct AsyncUpdateState
+  {
+    std::shared_ptr<std::atomic<std::uint64_t>> Generation;
+    bool IsPending{};
+  };
+
+  /// Completed updates shared with the worker threads.
+  struct AsyncUpdateQueue
+  {
+    std::mutex Mutex;
+    std::vector<AsyncUpdateResult> Completed;
+    /// Set by the workers when Completed is not empty
+    std::atomic<bool> HasCompleted{ false };
+  };
+
+  /// @{
+  /// Start / stop the interactor timer committing the prepared updates while updates are pending.
+  /// Returns false if the timer cannot be started (no render window interactor).
+  bool StartCommitTimer();
+  void StopCommitTimer();
+  /// @}
+
+  /// Reset the display of the dirty pipelines without requesting render.
+  /// Returns the number of reset pipelines.
+  int ResetDirtyPipelinesDisplay();
+
+  /// Configure the input pipeline for the input display node and add it to the layers and interaction logic.
+  void RegisterPipeline(vtkMRMLNode* displayNode, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline);
+
+  /// Invoke ModifiedEvent or defer it to the end of the batch processing.
+  void InvokePipelinesModified();
+
+  /// Create the pipelines of the nodes queued during batch processing.
+  void CreatePendingPipelines();
+
   /// Update the input pipeline and reset its display.
   void UpdatePipeline(const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline) const;
 
+  /// Record node added / removed scene events for the next \sa UpdateFromScene.
+  /// Nodes already processed by \sa AddNode in the same event (forwarded by the displayable manager) are not recorded.
+  void OnSceneNodeAdded(vtkMRMLNode* node);
+  void OnSceneNodeRemoved(vtkMRMLNode* node);
+
+  /// Process the scene changes recorded since the last update.
+  void ProcessPendingSceneChanges();
+
+  /// Probe the input creator for the scene nodes without pipeline.
+  /// Nodes without pipeline have been rejected by the other creators, only the new creator may accept them.
+  void CreatePipelinesForCreator(vtkMRMLLayerDMPipelineCreatorI* creator);
+
+  /// Configure and add the pipeline created for the input node.
+  void AddCreatedPipeline(vtkMRMLNode* displayNode, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline);
+
   /// Remove pipelines with nodes not present in the scene anymore.
   void RemoveOutdatedPipelines();
 
@@ -150,7 +396,9 @@ private:
   vtkSmartPointer<vtkMRMLLayerDMLayerManager> m_layerManager;
   vtkSmartPointer<vtkMRMLLayerDMCameraSynchronizer> m_cameraSync;
   vtkSmartPointer<vtkMRMLLayerDMInteractionLogic> m_interactionLogic;
+  vtkSmartPointer<vtkMRMLLayerDMInteractionLatency> m_interactionLatency;
   vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver> m_eventObs;
+  vtkSmartPointer<vtkMRMLLayerDMObjectEventObserver> m_sceneObs;
   vtkSmartPointer<vtkCamera> m_defaultCamera;
   vtkSmartPointer<vtkMRMLLayerDMNodeReferenceObserver> m_nodeRefObs;
 
@@ -158,8 +406,43 @@ private:
   vtkWeakPointer<vtkMRMLScene> m_scene;
   vtkWeakPointer<vtkRenderWindow> m_renderWindow;
 
-  std::map<vtkWeakPointer<vtkMRMLNode>, vtkSmartPointer<vtkMRMLLayerDMPipelineI>> m_pipelineMap;
+  layer_dm::PipelineRegistry m_pipelines;
   std::function<void()> m_requestRender;
 
   bool m_isRequestRenderBlocked{ false };
+  bool m_isPerformanceCountersEnabled{ false };
+  bool m_isSliceSlabClippingEnabled{ false };
+  double m_sliceSlabThickness{ 0 };
+
+  // Batch processing state
+  std::vector<vtkWeakPointer<vtkMRMLNode>> m_pendingNodes;
+  std::set<vtkMRMLNode*> m_pendingNodeSet;
+  bool m_isBatchProcessing{ false };
+  bool m_isBatchModified{ false };
+  bool m_wasRequestRenderBlockedBeforeBatch{ false };
+
+  // Deferred reset display state
+  std::vector<vtkWeakPointer<vtkMRMLLayerDMPipelineI>> m_dirtyPipelines;
+  std::set<const vtkMRMLLayerDMPipelineI*> m_dirtyPipelineSet;
+  int m_nCoalescedUpdates{ 0 };
+  int m_nFlushedUpdates{ 0 };
+
+  // Asynchronous update state
+  std::unordered_map<const vtkMRMLLayerDMPipelineI*, AsyncUpdateState> m_updateStates;
+  std::shared_ptr<AsyncUpdateQueue> m_completedUpdates;
+  vtkWeakPointer<vtkRenderWindowInteractor> m_commitInteractor;
+  int m_commitTimerId{ -1 };
+  int m_nUpdateThreads;
+  int m_nPendingUpdates{ 0 };
+  int m_nCommittedUpdates{ 0 };
+  int m_nCancelledUpdates{ 0 };
+
+  // Scene change tracking state
+  std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkMRMLNode>> m_sceneAddedNodes;
+  std::unordered_set<vtkMRMLNode*> m_sceneRemovedNodes;
+  vtkWeakPointer<vtkMRMLNode> m_lastAddedNode;
+  bool m_isFullSceneUpdateRequested{ true };
+
+  // Declared last to be stopped first on delete
+  std::unique_ptr<layer_dm::WorkStealingThreadPool> m_updatePool;
 };
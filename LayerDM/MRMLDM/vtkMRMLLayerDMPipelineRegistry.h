@@ -0,0 +1,291 @@
+#pragma once
+
+// Layer DM includes
+#include "vtkMRMLLayerDMPipelineI.h"
+
+// Slicer includes
+#include <vtkMRMLNode.h>
+
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STL includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace layer_dm
+{
+/// \brief Open-addressing (linear probing) hash index mapping addresses to storage indices.
+///
+/// Addresses are hashed using Fibonacci hashing : the address is multiplied by 2^64 / phi and the high bits of the
+/// product are used as slot. The high bits depend on all the address bits, which spreads the addresses allocated at
+/// power of two strides over the whole table.
+/// Removal uses backward shift deletion to keep the probe sequences valid without tombstones.
+class AddressIndex
+{
+public:
+  static constexpr std::size_t NotFound = static_cast<std::size_t>(-1);
+
+  /// Returns the index associated with the input address or \sa NotFound.
+  std::size_t Find(const void* key) const
+  {
+    const auto slot = this->FindSlot(key);
+    return slot != NotFound ? this->m_slots[slot].Index : NotFound;
+  }
+
+  /// Insert the input address which must not already be indexed.
+  void Insert(const void* key, std::size_t index)
+  {
+    // Keep the load factor under 0.5 to keep the probe sequences short
+    if (2 * (this->m_size + 1) > this->m_slots.size())
+    {
+      this->Rehash(std::max<std::size_t>(MinCapacity, 2 * this->m_slots.size()));
+    }
+    this->InsertSlot(key, index);
+    ++this->m_size;
+  }
+
+  /// Update the index associated with an indexed address.
+  void SetIndex(const void* key, std::size_t index)
+  {
+    if (const auto slot = this->FindSlot(key); slot != NotFound)
+    {
+      this->m_slots[slot].Index = index;
+    }
+  }
+
+  /// Remove the input address. Returns true if the address was indexed.
+  bool Erase(const void* key)
+  {
+    auto slot = this->FindSlot(key);
+    if (slot == NotFound)
+    {
+      return false;
+    }
+
+    const auto mask = this->m_slots.size() - 1;
+    auto next = (slot + 1) & mask;
+    while (this->m_slots[next].Key)
+    {
+      const auto ideal = this->HashSlot(this->m_slots[next].Key);
+      if (((next - ideal) & mask) >= ((next - slot) & mask))
+      {
+        this->m_slots[slot] = this->m_slots[next];
+        slot = next;
+      }
+      next = (next + 1) & mask;
+    }
+    this->m_slots[slot] = Slot{};
+    --this->m_size;
+    return true;
+  }
+
+  void Clear()
+  {
+    this->m_slots.clear();
+    this->m_size = 0;
+  }
+
+  std::size_t Size() const { return this->m_size; }
+
+  /// Returns the longest number of slots visited to find an indexed address.
+  std::size_t GetMaxProbeLength() const
+  {
+    const auto mask = this->m_slots.size() - 1;
+    std::size_t maxProbeLength = 0;
+    for (std::size_t slot = 0; slot < this->m_slots.size(); ++slot)
+    {
+      if (this->m_slots[slot].Key)
+      {
+        maxProbeLength = std::max(maxProbeLength, ((slot - this->HashSlot(this->m_slots[slot].Key)) & mask) + 1);
+      }
+    }
+    return maxProbeLength;
+  }
+
+private:
+  struct Slot
+  {
+    const void* Key{ nullptr };
+    std::size_t Index{ 0 };
+  };
+
+  static constexpr std::size_t MinCapacity = 16;
+
+  std::size_t HashSlot(const void* key) const
+  {
+    const auto value = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key));
+    return static_cast<std::size_t>((value * 0x9E3779B97F4A7C15ull) >> this->m_shift);
+  }
+
+  std::size_t FindSlot(const void* key) const
+  {
+    if (!key || this->m_slots.empty())
+    {
+      return NotFound;
+    }
+
+    const auto mask = this->m_slots.size() - 1;
+    for (auto slot = this->HashSlot(key);; slot = (slot + 1) & mask)
+    {
+      if (this->m_slots[slot].Key == key)
+      {
+        return slot;
+      }
+      if (!this->m_slots[slot].Key)
+      {
+        return NotFound;
+      }
+    }
+  }
+
+  void InsertSlot(const void* key, std::size_t index)
+  {
+    const auto mask = this->m_slots.size() - 1;
+    auto slot = this->HashSlot(key);
+    while (this->m_slots[slot].Key)
+    {
+      slot = (slot + 1) & mask;
+    }
+    this->m_slots[slot] = Slot{ key, index };
+  }
+
+  /// Capacity must be a power of two
+  void Rehash(std::size_t capacity)
+  {
+    std::vector<Slot> slots(capacity);
+    std::swap(slots, this->m_slots);
+
+    this->m_shift = 64;
+    for (auto size = capacity; size > 1; size >>= 1)
+    {
+      --this->m_shift;
+    }
+
+    for (const auto& slot : slots)
+    {
+      if (slot.Key)
+      {
+        this->InsertSlot(slot.Key, slot.Index);
+      }
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  std::size_t m_size{ 0 };
+
+  /// 64 - log2(capacity)
+  unsigned int m_shift{ 64 };
+};
+
+/// \brief Flat node to pipeline registry used by \sa vtkMRMLLayerDMPipelineManager.
+///
+/// Pipelines are stored contiguously to allow O(1) Nth access and cache friendly sweeps.
+/// Nodes are indexed by an \sa AddressIndex mapping the node address to its storage slot.
+/// Removal swaps the last entry in the removed slot : the registry order is not preserved on removal.
+///
+/// Nodes are indexed by their address at insertion time. The stored weak pointer allows to detect nodes which have
+/// been deleted while still registered (\sa Entry::Node is then nullptr while \sa Entry::Key can still be used for removal).
+/// The entries of deleted nodes are stale : they are not found by \sa Find and \sa Contains, even for a new node allocated
+/// at the same address, and are replaced on \sa Insert. \sa FindByKey gives access to their pipeline for cleanup.
+class PipelineRegistry
+{
+public:
+  struct Entry
+  {
+    vtkMRMLNode* Key{ nullptr };
+    vtkWeakPointer<vtkMRMLNode> Node;
+    vtkSmartPointer<vtkMRMLLayerDMPipelineI> Pipeline;
+  };
+
+  /// Insert or replace the pipeline associated with the input node.
+  /// Returns true if the node was not already registered.
+  bool Insert(vtkMRMLNode* node, const vtkSmartPointer<vtkMRMLLayerDMPipelineI>& pipeline)
+  {
+    if (!node)
+    {
+      return false;
+    }
+
+    if (const auto found = this->m_index.Find(node); found != AddressIndex::NotFound)
+    {
+      // Stale entries of deleted nodes allocated at the same address are replaced
+      auto& entry = this->m_entries[found];
+      const bool isStale = entry.Node.GetPointer() != node;
+      entry.Node = node;
+      entry.Pipeline = pipeline;
+      return isStale;
+    }
+
+    this->m_entries.push_back(Entry{ node, node, pipeline });
+    this->m_index.Insert(node, this->m_entries.size() - 1);
+    return true;
+  }
+
+  /// Returns the pipeline associated with the input node or nullptr if the node is not registered.
+  /// Stale entries are ignored.
+  vtkMRMLLayerDMPipelineI* Find(const vtkMRMLNode* node) const
+  {
+    const auto found = this->FindLiveEntry(node);
+    return found != AddressIndex::NotFound ? this->m_entries[found].Pipeline.GetPointer() : nullptr;
+  }
+
+  /// Returns the pipeline registered at the input node address, including the stale entries.
+  vtkMRMLLayerDMPipelineI* FindByKey(const vtkMRMLNode* key) const
+  {
+    const auto found = this->m_index.Find(key);
+    return found != AddressIndex::NotFound ? this->m_entries[found].Pipeline.GetPointer() : nullptr;
+  }
+
+  /// Remove the input node from the registry.
+  /// The last entry is moved to the slot of the removed entry.
+  /// Returns true if the node was registered.
+  bool Erase(const vtkMRMLNode* node)
+  {
+    const auto index = this->m_index.Find(node);
+    if (index == AddressIndex::NotFound)
+    {
+      return false;
+    }
+
+    // Swap remove the entry and update the index of the moved entry
+    const auto last = this->m_entries.size() - 1;
+    if (index != last)
+    {
+      this->m_entries[index] = std::move(this->m_entries[last]);
+      this->m_index.SetIndex(this->m_entries[index].Key, index);
+    }
+    this->m_entries.pop_back();
+    this->m_index.Erase(node);
+    return true;
+  }
+
+  void Clear()
+  {
+    this->m_entries.clear();
+    this->m_index.Clear();
+  }
+
+  bool Contains(const vtkMRMLNode* node) const { return this->FindLiveEntry(node) != AddressIndex::NotFound; }
+  bool Empty() const { return this->m_entries.empty(); }
+  std::size_t Size() const { return this->m_entries.size(); }
+
+  const Entry& operator[](std::size_t index) const { return this->m_entries[index]; }
+  std::vector<Entry>::const_iterator begin() const { return this->m_entries.begin(); }
+  std::vector<Entry>::const_iterator end() const { return this->m_entries.end(); }
+
+private:
+  std::size_t FindLiveEntry(const vtkMRMLNode* node) const
+  {
+    const auto found = this->m_index.Find(node);
+    return found != AddressIndex::NotFound && this->m_entries[found].Node.GetPointer() == node ? found : AddressIndex::NotFound;
+  }
+
+  std::vector<Entry> m_entries;
+  AddressIndex m_index;
+};
+} // namespace layer_dm
@@ -132,6 +132,12 @@ int vtkMRMLLayerDMScriptedPipelineBridge::GetWidgetState() const
   return Superclass::GetWidgetState();
 }
 
+bool vtkMRMLLayerDMScriptedPipelineBridge::IsReentrantCanProcessInteractionEvent() const
+{
+  // Python calls require the GIL, scripted pipelines are always polled on the main thread
+  return false;
+}
+
 void vtkMRMLLayerDMScriptedPipelineBridge::LoseFocus(vtkMRMLInteractionEventData* eventData)
 {
   if (!vtkMRMLLayerDMPythonUtil::IsValidPythonContext())
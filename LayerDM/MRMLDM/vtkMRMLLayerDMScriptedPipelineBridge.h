@@ -25,6 +25,7 @@ public:
   int GetMouseCursor() const override;
   unsigned int GetRenderOrder() const override;
   int GetWidgetState() const override;
+  bool IsReentrantCanProcessInteractionEvent() const override;
   void LoseFocus(vtkMRMLInteractionEventData* eventData) override;
   void OnDefaultCameraModified(vtkCamera* camera) override;
   void OnReferenceToDisplayNodeAdded(vtkMRMLNode* fromNode, const std::string& role) override;
@@ -0,0 +1,179 @@
+#pragma once
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace layer_dm
+{
+/// \brief Work stealing thread pool used by \sa vtkMRMLLayerDMPipelineManager for the asynchronous pipeline updates.
+///
+/// Each worker owns a task deque. Submitted tasks are distributed in round-robin on the workers.
+/// Workers pop tasks from the front of their own deque and steal tasks from the back of the other workers' deques when
+/// their own deque is empty.
+///
+/// Tasks still queued when the pool is destroyed are discarded without being run and are released on the destroying
+/// thread. Running tasks are waited for.
+class WorkStealingThreadPool
+{
+public:
+  explicit WorkStealingThreadPool(unsigned int nThreads)
+  {
+    nThreads = std::max(1u, nThreads);
+    for (unsigned int iWorker = 0; iWorker < nThreads; ++iWorker)
+    {
+      this->m_workers.emplace_back(std::make_unique<Worker>());
+    }
+    for (unsigned int iWorker = 0; iWorker < nThreads; ++iWorker)
+    {
+      this->m_threads.emplace_back([this, iWorker] { this->Run(iWorker); });
+    }
+  }
+
+  ~WorkStealingThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      this->m_isStopping = true;
+    }
+    this->m_wakeUp.notify_all();
+
+    // Workers don't pop tasks once stopping, the queued tasks can be released here
+    for (auto& worker : this->m_workers)
+    {
+      std::deque<std::function<void()>> discarded;
+      {
+        std::lock_guard<std::mutex> workerLock(worker->Mutex);
+        std::swap(discarded, worker->Tasks);
+      }
+    }
+
+    for (auto& thread : this->m_threads)
+    {
+      thread.join();
+    }
+  }
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  /// Queue the input task for execution on one of the workers.
+  void Submit(std::function<void()> task)
+  {
+    {
+      // Counters are updated under the pool lock and before the task is visible to avoid missing wake ups
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      this->m_nQueued++;
+      this->m_nUnfinished++;
+    }
+    auto& worker = *this->m_workers[this->m_nextWorker++ % this->m_workers.size()];
+    {
+      std::lock_guard<std::mutex> workerLock(worker.Mutex);
+      worker.Tasks.emplace_back(std::move(task));
+    }
+    this->m_wakeUp.notify_one();
+  }
+
+  /// Block until all the submitted tasks have been executed.
+  void WaitIdle()
+  {
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    this->m_idle.wait(lock, [this] { return this->m_nUnfinished == 0; });
+  }
+
+  std::size_t GetNumberOfThreads() const { return this->m_threads.size(); }
+
+private:
+  struct Worker
+  {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  bool TryPop(std::size_t iWorker, std::function<void()>& task)
+  {
+    auto& worker = *this->m_workers[iWorker];
+    std::lock_guard<std::mutex> workerLock(worker.Mutex);
+    if (worker.Tasks.empty())
+    {
+      return false;
+    }
+    task = std::move(worker.Tasks.front());
+    worker.Tasks.pop_front();
+    return true;
+  }
+
+  bool TrySteal(std::size_t iWorker, std::function<void()>& task)
+  {
+    for (std::size_t iOffset = 1; iOffset < this->m_workers.size(); ++iOffset)
+    {
+      auto& victim = *this->m_workers[(iWorker + iOffset) % this->m_workers.size()];
+      std::lock_guard<std::mutex> victimLock(victim.Mutex);
+      if (!victim.Tasks.empty())
+      {
+        task = std::move(victim.Tasks.back());
+        victim.Tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Run(std::size_t iWorker)
+  {
+    while (true)
+    {
+      // Stop is checked before popping so that the queued tasks are discarded instead of being run
+      {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        this->m_wakeUp.wait(lock, [this] { return this->m_isStopping || this->m_nQueued > 0; });
+        if (this->m_isStopping)
+        {
+          return;
+        }
+      }
+
+      std::function<void()> task;
+      if (!this->TryPop(iWorker, task) && !this->TrySteal(iWorker, task))
+      {
+        // Task was taken by another worker before it decremented the queued count
+        std::this_thread::yield();
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_nQueued--;
+      }
+      task();
+      task = nullptr;
+
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      if (--this->m_nUnfinished == 0)
+      {
+        this->m_idle.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+  std::atomic<std::size_t> m_nextWorker{ 0 };
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::condition_variable m_idle;
+  std::size_t m_nQueued{ 0 };
+  std::size_t m_nUnfinished{ 0 };
+  bool m_isStopping{ false };
+};
+} // namespace layer_dm
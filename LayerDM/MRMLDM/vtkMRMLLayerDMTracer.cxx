@@ -0,0 +1,389 @@
+#include "vtkMRMLLayerDMTracer.h"
+
+// Slicer includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLNode.h>
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+constexpr int DefaultBufferCapacity = 65536;
+
+void CopyArgument(char (&dst)[vtkMRMLLayerDMTracer::MaxArgumentLength], const char* src)
+{
+  if (!src)
+  {
+    dst[0] = '\0';
+    return;
+  }
+  std::snprintf(dst, vtkMRMLLayerDMTracer::MaxArgumentLength, "%s", src);
+}
+
+void WriteJSONString(std::ostream& stream, const char* str)
+{
+  stream << '"';
+  for (const char* c = str ? str : ""; *c != '\0'; ++c)
+  {
+    switch (*c)
+    {
+      case '"': stream << "\\\""; break;
+      case '\\': stream << "\\\\"; break;
+      case '\n': stream << "\\n"; break;
+      case '\r': stream << "\\r"; break;
+      case '\t': stream << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20)
+        {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(*c));
+          stream << escaped;
+        }
+        else
+        {
+          stream << *c;
+        }
+    }
+  }
+  stream << '"';
+}
+
+std::uint64_t NextTracerId()
+{
+  static std::atomic<std::uint64_t> nextId{ 1 };
+  return nextId++;
+}
+} // namespace
+
+/// Event buffer written by a single thread.
+/// Head and Start are monotonic event counters, the event of counter i is stored at index i % capacity.
+struct vtkMRMLLayerDMTracer::ThreadBuffer
+{
+  /// Event storage guarded by a sequence lock.
+  /// Sequence is 2 * i + 1 while the event of counter i is written and 2 * i + 2 once it is published.
+  struct Slot
+  {
+    std::atomic<std::uint64_t> Sequence{ 0 };
+    Event Data;
+  };
+
+  ThreadBuffer(int capacity, int threadId)
+    : Events(std::max(1, capacity))
+    , ThreadId(threadId)
+    , Owner(std::this_thread::get_id())
+  {
+  }
+
+  std::vector<Slot> Events;
+  const int ThreadId;
+  const std::thread::id Owner;
+  std::atomic<std::uint64_t> Head{ 0 };
+  std::atomic<std::uint64_t> Start{ 0 };
+  std::atomic<std::uint64_t> Dropped{ 0 };
+};
+
+vtkStandardNewMacro(vtkMRMLLayerDMTracer);
+
+vtkMRMLLayerDMTracer::vtkMRMLLayerDMTracer()
+  : m_id(NextTracerId())
+  , m_origin(std::chrono::steady_clock::now())
+  , m_capacity(DefaultBufferCapacity)
+{
+}
+
+vtkMRMLLayerDMTracer::~vtkMRMLLayerDMTracer() = default;
+
+vtkSmartPointer<vtkMRMLLayerDMTracer> vtkMRMLLayerDMTracer::GetInstance()
+{
+  return GetInstancePointer();
+}
+
+vtkMRMLLayerDMTracer* vtkMRMLLayerDMTracer::GetInstancePointer()
+{
+  static vtkSmartPointer<vtkMRMLLayerDMTracer> instance = vtkSmartPointer<vtkMRMLLayerDMTracer>::New();
+  return instance;
+}
+
+void vtkMRMLLayerDMTracer::SetEnabled(bool isEnabled)
+{
+  if (this->m_isEnabled.exchange(isEnabled) != isEnabled)
+  {
+    this->Modified();
+  }
+}
+
+bool vtkMRMLLayerDMTracer::IsEnabled() const
+{
+  return this->m_isEnabled.load(std::memory_order_relaxed);
+}
+
+void vtkMRMLLayerDMTracer::SetRingBufferMode(bool isRingBuffer)
+{
+  if (this->m_isRingBuffer.exchange(isRingBuffer) != isRingBuffer)
+  {
+    this->Modified();
+  }
+}
+
+bool vtkMRMLLayerDMTracer::IsRingBufferMode() const
+{
+  return this->m_isRingBuffer;
+}
+
+void vtkMRMLLayerDMTracer::SetBufferCapacity(int capacity)
+{
+  capacity = std::max(1, capacity);
+  {
+    std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+    if (this->m_capacity == capacity)
+    {
+      return;
+    }
+
+    // Threads will register new buffers with the new capacity on their next event
+    this->m_capacity = capacity;
+    std::move(this->m_buffers.begin(), this->m_buffers.end(), std::back_inserter(this->m_retiredBuffers));
+    this->m_buffers.clear();
+    this->m_generation++;
+  }
+  this->Modified();
+}
+
+int vtkMRMLLayerDMTracer::GetBufferCapacity() const
+{
+  return this->m_capacity;
+}
+
+double vtkMRMLLayerDMTracer::GetTimestamp() const
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this->m_origin).count();
+}
+
+void vtkMRMLLayerDMTracer::Record(const Event& event)
+{
+  auto buffer = this->GetThreadBuffer();
+  const auto capacity = static_cast<std::uint64_t>(buffer->Events.size());
+  const auto head = buffer->Head.load(std::memory_order_relaxed);
+  if (!this->m_isRingBuffer.load(std::memory_order_relaxed) && head - buffer->Start.load(std::memory_order_acquire) >= capacity)
+  {
+    buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Readers exporting concurrently discard the slot while its sequence is odd or has changed during their copy
+  auto& slot = buffer->Events[head % capacity];
+  slot.Sequence.store(2 * head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.Data = event;
+  slot.Sequence.store(2 * head + 2, std::memory_order_release);
+  buffer->Head.store(head + 1, std::memory_order_release);
+}
+
+vtkMRMLLayerDMTracer::ThreadBuffer* vtkMRMLLayerDMTracer::GetThreadBuffer()
+{
+  struct ThreadCache
+  {
+    std::uint64_t TracerId{ 0 };
+    std::uint64_t Generation{ 0 };
+    ThreadBuffer* Buffer{ nullptr };
+  };
+  thread_local ThreadCache cache;
+
+  if (cache.Buffer && cache.TracerId == this->m_id && cache.Generation == this->m_generation.load(std::memory_order_acquire))
+  {
+    return cache.Buffer;
+  }
+
+  // Slow path executed once per thread and per generation
+  std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+  const auto threadId = std::this_thread::get_id();
+  auto it = std::find_if(this->m_buffers.begin(), this->m_buffers.end(), [&threadId](const auto& buffer) { return buffer->Owner == threadId; });
+  if (it == this->m_buffers.end())
+  {
+    this->m_buffers.emplace_back(std::make_unique<ThreadBuffer>(this->m_capacity, this->m_nextThreadId++));
+    it = std::prev(this->m_buffers.end());
+  }
+
+  cache = { this->m_id, this->m_generation.load(), it->get() };
+  return cache.Buffer;
+}
+
+void vtkMRMLLayerDMTracer::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+  for (const auto& buffer : this->m_buffers)
+  {
+    buffer->Start.store(buffer->Head.load(std::memory_order_acquire), std::memory_order_release);
+    buffer->Dropped = 0;
+  }
+}
+
+int vtkMRMLLayerDMTracer::GetNumberOfEvents() const
+{
+  std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+  std::uint64_t nEvents = 0;
+  for (const auto& buffer : this->m_buffers)
+  {
+    const auto head = buffer->Head.load(std::memory_order_acquire);
+    nEvents += std::min<std::uint64_t>(head - std::min(head, buffer->Start.load()), buffer->Events.size());
+  }
+  return static_cast<int>(nEvents);
+}
+
+int vtkMRMLLayerDMTracer::GetNumberOfDroppedEvents() const
+{
+  std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+  std::uint64_t nDropped = 0;
+  for (const auto& buffer : this->m_buffers)
+  {
+    nDropped += buffer->Dropped.load(std::memory_order_relaxed);
+  }
+  return static_cast<int>(nDropped);
+}
+
+std::string vtkMRMLLayerDMTracer::GetChromeTrace() const
+{
+  std::ostringstream stream;
+  stream.imbue(std::locale::classic());
+  stream.setf(std::ios::fixed);
+  stream.precision(3);
+
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool isFirst = true;
+  const auto separator = [&isFirst, &stream]
+  {
+    if (!isFirst)
+    {
+      stream << ",\n";
+    }
+    isFirst = false;
+  };
+
+  std::lock_guard<std::mutex> lock(this->m_buffersMutex);
+  std::vector<Event> events;
+  for (const auto& buffer : this->m_buffers)
+  {
+    // Copy the published events. Slots overwritten by the writing thread before or during their copy no longer hold the
+    // sequence of the expected event and are skipped.
+    const auto capacity = static_cast<std::uint64_t>(buffer->Events.size());
+    const auto head = buffer->Head.load(std::memory_order_acquire);
+    const auto start = std::max(buffer->Start.load(std::memory_order_acquire), head > capacity ? head - capacity : 0);
+    events.clear();
+    for (auto iEvent = start; iEvent < head; ++iEvent)
+    {
+      const auto& slot = buffer->Events[iEvent % capacity];
+      const auto published = 2 * iEvent + 2;
+      if (slot.Sequence.load(std::memory_order_acquire) != published)
+      {
+        continue;
+      }
+
+      const Event event = slot.Data;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.Sequence.load(std::memory_order_relaxed) == published)
+      {
+        events.emplace_back(event);
+      }
+    }
+
+    separator();
+    stream << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->ThreadId << R"(,"args":{"name":"LayerDM thread )" << buffer->ThreadId
+           << "\"}}";
+
+    for (const auto& event : events)
+    {
+      separator();
+      stream << "{\"name\":";
+      WriteJSONString(stream, event.Name);
+      stream << ",\"cat\":";
+      WriteJSONString(stream, event.Category);
+      stream << R"(,"ph":"X","pid":1,"tid":)" << buffer->ThreadId << ",\"ts\":" << event.Start << ",\"dur\":" << event.Duration << ",\"args\":{\"node\":";
+      WriteJSONString(stream, event.NodeID);
+      stream << ",\"pipeline\":";
+      WriteJSONString(stream, event.PipelineClass);
+      stream << ",\"view\":";
+      WriteJSONString(stream, event.ViewName);
+      stream << "}}";
+    }
+  }
+  stream << "]}\n";
+  return stream.str();
+}
+
+bool vtkMRMLLayerDMTracer::WriteChromeTrace(const std::string& path) const
+{
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file)
+  {
+    vtkErrorMacro("vtkMRMLLayerDMTracer::WriteChromeTrace() failed: unable to open " << path);
+    return false;
+  }
+  file << this->GetChromeTrace();
+  return static_cast<bool>(file);
+}
+
+vtkMRMLLayerDMTracer::Scope::Scope(const char* name, const char* category)
+{
+  auto tracer = vtkMRMLLayerDMTracer::GetInstancePointer();
+  if (!tracer->IsEnabled())
+  {
+    return;
+  }
+
+  this->m_tracer = tracer;
+  this->m_event.Name = name;
+  this->m_event.Category = category;
+  this->m_event.Start = tracer->GetTimestamp();
+}
+
+vtkMRMLLayerDMTracer::Scope::~Scope()
+{
+  if (!this->m_tracer)
+  {
+    return;
+  }
+
+  this->m_event.Duration = this->m_tracer->GetTimestamp() - this->m_event.Start;
+  this->m_tracer->Record(this->m_event);
+}
+
+vtkMRMLLayerDMTracer::Scope& vtkMRMLLayerDMTracer::Scope::SetNode(vtkMRMLNode* node)
+{
+  if (this->m_tracer && node)
+  {
+    CopyArgument(this->m_event.NodeID, node->GetID());
+  }
+  return *this;
+}
+
+vtkMRMLLayerDMTracer::Scope& vtkMRMLLayerDMTracer::Scope::SetPipeline(vtkObject* pipeline)
+{
+  if (this->m_tracer && pipeline)
+  {
+    CopyArgument(this->m_event.PipelineClass, pipeline->GetClassName());
+  }
+  return *this;
+}
+
+vtkMRMLLayerDMTracer::Scope& vtkMRMLLayerDMTracer::Scope::SetView(vtkMRMLAbstractViewNode* viewNode)
+{
+  if (!this->m_tracer || !viewNode)
+  {
+    return *this;
+  }
+
+  const char* layoutName = viewNode->GetLayoutName();
+  CopyArgument(this->m_event.ViewName, layoutName && layoutName[0] != '\0' ? layoutName : viewNode->GetID());
+  return *this;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class vtkMRMLAbstractViewNode;
+class vtkMRMLNode;
+
+/// \brief Records the timing of the Layer DM hot paths and exports them in the Chrome trace JSON format.
+///
+/// The exported traces can be opened in chrome://tracing or in the Perfetto UI (https://ui.perfetto.dev).
+/// Traced events carry the node ID, pipeline class and view name they apply to when available.
+///
+/// Events are recorded in per-thread buffers. Each buffer is only written by its owning thread and published using an
+/// atomic head index, recording an event doesn't require any lock. Each event slot carries a sequence number so that
+/// exporting concurrently with the recording never returns partially overwritten events. Buffers have a fixed capacity :
+///   - By default, events recorded when the buffer is full are dropped and counted \sa GetNumberOfDroppedEvents
+///   - In ring buffer mode, the oldest events are overwritten which allows always-on capture of the latest events.
+///
+/// Tracing is disabled by default and \sa Scope is a no-op when disabled.
+class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT vtkMRMLLayerDMTracer : public vtkObject
+{
+public:
+  static vtkMRMLLayerDMTracer* New();
+  vtkTypeMacro(vtkMRMLLayerDMTracer, vtkObject);
+
+  /// \brief Singleton instance of the tracer used by the Layer DM classes
+  static vtkSmartPointer<vtkMRMLLayerDMTracer> GetInstance();
+
+  /// \brief Maximum size of the event text arguments. Longer arguments are truncated.
+  static constexpr int MaxArgumentLength = 64;
+
+  /// \brief Traced event. Name and category are expected to be static strings.
+  struct Event
+  {
+    const char* Name{ nullptr };
+    const char* Category{ nullptr };
+    double Start{ 0 };
+    double Duration{ 0 };
+    char NodeID[MaxArgumentLength]{};
+    char PipelineClass[MaxArgumentLength]{};
+    char ViewName[MaxArgumentLength]{};
+  };
+
+  /// \brief RAII helper recording an event spanning its lifetime in the singleton tracer.
+  /// Does nothing if the tracer is disabled when the scope is constructed.
+  class VTK_SLICER_LAYERDM_MODULE_MRMLDISPLAYABLEMANAGER_EXPORT Scope
+  {
+  public:
+    Scope(const char* name, const char* category);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /// @{
+    /// Set the event arguments. Ignored if the tracer is disabled.
+    Scope& SetNode(vtkMRMLNode* node);
+    Scope& SetPipeline(vtkObject* pipeline);
+    Scope& SetView(vtkMRMLAbstractViewNode* viewNode);
+    /// @}
+
+  private:
+    vtkMRMLLayerDMTracer* m_tracer{ nullptr };
+    Event m_event;
+  };
+
+  /// @{
+  /// Enable / disable the event recording.
+  void SetEnabled(bool isEnabled);
+  bool IsEnabled() const;
+  /// @}
+
+  /// @{
+  /// When enabled, the oldest events are overwritten when a thread buffer is full instead of dropping the new events.
+  void SetRingBufferMode(bool isRingBuffer);
+  bool IsRingBufferMode() const;
+  /// @}
+
+  /// @{
+  /// Number of events each thread buffer can hold (default 65536).
+  /// Changing the capacity discards the recorded events.
+  void SetBufferCapacity(int capacity);
+  int GetBufferCapacity() const;
+  /// @}
+
+  /// \brief Record the input event in the calling thread's buffer.
+  /// Start and duration are expected in microseconds relative to \sa GetTimestamp.
+  void Record(const Event& event);
+
+  /// \brief Current time in microseconds relative to the tracer creation.
+  double GetTimestamp() const;
+
+  /// \brief Discard the recorded events and reset the dropped events count.
+  void Clear();
+
+  /// \brief Number of events currently held by the thread buffers.
+  int GetNumberOfEvents() const;
+
+  /// \brief Number of events dropped since the last clear because their thread buffer was full.
+  /// Always 0 in ring buffer mode.
+  int GetNumberOfDroppedEvents() const;
+
+  /// \brief Recorded events in the Chrome trace JSON format.
+  /// Can be called while events are being recorded. In ring buffer mode, events overwritten before or during their copy
+  /// are skipped.
+  std::string GetChromeTrace() const;
+
+  /// \brief Write the recorded events in the Chrome trace JSON format to the input path.
+  /// Returns false if the file couldn't be written.
+  bool WriteChromeTrace(const std::string& path) const;
+
+protected:
+  vtkMRMLLayerDMTracer();
+  ~vtkMRMLLayerDMTracer() override;
+
+private:
+  struct ThreadBuffer;
+
+  ThreadBuffer* GetThreadBuffer();
+  static vtkMRMLLayerDMTracer* GetInstancePointer();
+
+  const std::uint64_t m_id;
+  const std::chrono::steady_clock::time_point m_origin;
+  std::atomic<bool> m_isEnabled{ false };
+  std::atomic<bool> m_isRingBuffer{ false };
+  std::atomic<int> m_capacity;
+  std::atomic<std::uint64_t> m_generation{ 0 };
+
+  // Buffers are only created / retired under the lock. Retired buffers are kept alive until the tracer is destroyed as
+  // writing threads may still hold a pointer to them.
+  mutable std::mutex m_buffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+  std::vector<std::unique_ptr<ThreadBuffer>> m_retiredBuffers;
+  int m_nextThreadId{ 1 };
+};
@@ -1,11 +1,13 @@
 #include "vtkMRMLLayerDisplayableManager.h"
 
 // Layer DM includes
+#include "vtkMRMLLayerDMInteractionLatency.h"
 #include "vtkMRMLLayerDMPipelineFactory.h"
 #include "vtkMRMLLayerDMPipelineManager.h"
 
 // Slicer includes
 #include "vtkMRMLAbstractViewNode.h"
+#include "vtkMRMLInteractionEventData.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSliceViewDisplayableManagerFactory.h"
 #include "vtkMRMLThreeDViewDisplayableManagerFactory.h"
@@ -33,6 +35,7 @@ bool vtkMRMLLayerDisplayableManager::CanProcessInteractionEvent(vtkMRMLInteracti
     return false;
   }
 
+  this->m_pipelineManager->GetInteractionLatency()->BeginEvent(eventData->GetType());
   return this->m_pipelineManager->CanProcessInteractionEvent(eventData, distance2);
 }
 
@@ -43,7 +46,12 @@ bool vtkMRMLLayerDisplayableManager::ProcessInteractionEvent(vtkMRMLInteractionE
     return false;
   }
 
-  return this->m_pipelineManager->ProcessInteractionEvent(eventData);
+  const bool didProcess = this->m_pipelineManager->ProcessInteractionEvent(eventData);
+  if (didProcess)
+  {
+    this->m_pipelineManager->GetInteractionLatency()->EndProcessing(this->m_pipelineManager->GetLastFocusedPipeline());
+  }
+  return didProcess;
 }
 
 void vtkMRMLLayerDisplayableManager::RegisterInDefaultViews()
@@ -79,13 +87,18 @@ vtkSmartPointer<vtkMRMLLayerDMPipelineI> vtkMRMLLayerDisplayableManager::GetNode
   return m_pipelineManager->GetNodePipeline(node);
 }
 
+vtkMRMLLayerDMInteractionLatency* vtkMRMLLayerDisplayableManager::GetInteractionLatency() const
+{
+  return this->m_pipelineManager ? this->m_pipelineManager->GetInteractionLatency() : nullptr;
+}
+
 void vtkMRMLLayerDisplayableManager::OnMRMLSceneStartBatchProcess()
 {
   if (!this->m_pipelineManager)
   {
     return;
   }
-  this->m_pipelineManager->BlockRequestRender(true);
+  this->m_pipelineManager->StartBatchProcess();
 }
 
 void vtkMRMLLayerDisplayableManager::OnMRMLSceneEndBatchProcess()
@@ -94,8 +107,7 @@ void vtkMRMLLayerDisplayableManager::OnMRMLSceneEndBatchProcess()
   {
     return;
   }
-  this->m_pipelineManager->BlockRequestRender(false);
-  this->m_pipelineManager->RequestRender();
+  this->m_pipelineManager->EndBatchProcess();
 }
 
 void vtkMRMLLayerDisplayableManager::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
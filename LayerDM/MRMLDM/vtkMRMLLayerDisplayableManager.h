@@ -10,6 +10,7 @@
 
 class vtkImageData;
 class vtkMRMLDisplayableManagerFactory;
+class vtkMRMLLayerDMInteractionLatency;
 class vtkMRMLLayerDMPipelineI;
 class vtkMRMLLayerDMPipelineManager;
 class vtkRenderWindow;
@@ -46,6 +47,12 @@ public:
   /// Runtime access logic shouldn't be necessary outside the LayerDM layer.
   vtkSmartPointer<vtkMRMLLayerDMPipelineI> GetNodePipeline(vtkMRMLNode* node) const;
 
+  /// Returns the interaction latency histograms of the displayable manager view.
+  /// Latencies are measured from the event entering \sa CanProcessInteractionEvent. nullptr before the displayable
+  /// manager is created.
+  /// \sa vtkMRMLLayerDMInteractionLatency
+  vtkMRMLLayerDMInteractionLatency* GetInteractionLatency() const;
+
   /// @{
   /// Utility function to get the content of the render window image as buffer
   /// Doesn't render / make any changes to the render window nor its renderers / cameras.
@@ -1,5 +1,7 @@
 set(classes
+  vtkMRMLLayerDMCachedRenderPass
   vtkMRMLLayerDMCameraSynchronizer
+  vtkMRMLLayerDMInteractionLatency
   vtkMRMLLayerDMInteractionLogic
   vtkMRMLLayerDMLayerManager
   vtkMRMLLayerDMPipelineCallbackCreator
@@ -7,13 +9,18 @@ set(classes
   vtkMRMLLayerDMPipelineFactory
   vtkMRMLLayerDMPipelineI
   vtkMRMLLayerDMPipelineManager
+  vtkMRMLLayerDMTracer
   vtkMRMLLayerDisplayableManager
   vtkMRMLLayerDMPipelineScriptedCreator
   vtkMRMLLayerDMScriptedPipelineBridge
 )
 
 set(headers
+  vtkMRMLLayerDMBoundingVolumeHierarchy.h
+  vtkMRMLLayerDMLatencyHistogram.h
   vtkMRMLLayerDMPipelineCreateHelper.h
+  vtkMRMLLayerDMPipelineRegistry.h
+  vtkMRMLLayerDMThreadPool.h
   vtkSlicerLayerDMModuleMRMLDisplayableManagerExport.h
 )
 
@@ -0,0 +1,39 @@
+#include "AllocationCounter.h"
+
+// STL includes
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<long long> nAllocations{ 0 };
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  nAllocations++;
+  if (void* ptr = std::malloc(size ? size : 1))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace layer_dm
+{
+long long GetNumberOfAllocations()
+{
+  return nAllocations.load();
+}
+} // namespace layer_dm
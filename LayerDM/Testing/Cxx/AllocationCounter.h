@@ -0,0 +1,8 @@
+#pragma once
+
+namespace layer_dm
+{
+/// Number of heap allocations done through the global operator new since the test executable started.
+/// The global operator new / delete are replaced in AllocationCounter.cxx for all the tests of the executable.
+long long GetNumberOfAllocations();
+} // namespace layer_dm
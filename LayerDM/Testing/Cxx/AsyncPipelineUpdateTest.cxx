@@ -0,0 +1,193 @@
+// LayerDM includes
+#include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMPipelineManager.h"
+#include "vtkMRMLLayerDMThreadPool.h"
+
+// VTK includes
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <ctkTest.h>
+
+namespace
+{
+/// Two-phase pipeline forwarding its snapshot as prepared data.
+/// Prepare can be blocked until the gate is opened to simulate long running updates.
+class AsyncPipeline : public vtkMRMLLayerDMPipelineI
+{
+public:
+  static AsyncPipeline* New();
+  vtkTypeMacro(AsyncPipeline, vtkMRMLLayerDMPipelineI);
+
+  vtkSmartPointer<vtkObject> CreateUpdateSnapshot() override
+  {
+    lastSnapshot = vtkSmartPointer<vtkObject>::New();
+    return lastSnapshot;
+  }
+
+  vtkSmartPointer<vtkObject> PrepareUpdate(vtkObject* snapshot) const override
+  {
+    if (gate.valid())
+    {
+      gate.wait();
+    }
+    nPrepared++;
+    return snapshot;
+  }
+
+  void CommitUpdate(vtkObject* preparedData) override
+  {
+    committed = preparedData;
+    nCommitted++;
+  }
+
+  vtkSmartPointer<vtkObject> lastSnapshot;
+  vtkSmartPointer<vtkObject> committed;
+  std::shared_future<void> gate;
+  mutable std::atomic<int> nPrepared{ 0 };
+  int nCommitted{ 0 };
+
+protected:
+  AsyncPipeline() = default;
+  ~AsyncPipeline() override = default;
+};
+
+vtkStandardNewMacro(AsyncPipeline);
+} // namespace
+
+class AsyncPipelineUpdateTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testPreparedUpdatesAreCommittedOnMainThread() const
+  {
+    vtkNew<vtkMRMLLayerDMPipelineManager> manager;
+    vtkNew<AsyncPipeline> pipeline;
+    pipeline->SetPipelineManager(manager);
+
+    manager->SchedulePipelineUpdate(pipeline);
+    QVERIFY(pipeline->IsUpdatePending());
+    QVERIFY(!pipeline->committed);
+
+    manager->WaitForPipelineUpdates();
+    QVERIFY(!pipeline->IsUpdatePending());
+    QCOMPARE(pipeline->committed.GetPointer(), pipeline->lastSnapshot.GetPointer());
+    QCOMPARE(manager->GetNumberOfCommittedUpdates(), 1);
+    QCOMPARE(manager->GetNumberOfPendingUpdates(), 0);
+  }
+
+  void testStaleUpdatesAreCancelled() const
+  {
+    vtkNew<vtkMRMLLayerDMPipelineManager> manager;
+    manager->SetNumberOfUpdateThreads(1);
+
+    vtkNew<AsyncPipeline> pipeline;
+    pipeline->SetPipelineManager(manager);
+    std::promise<void> gate;
+    pipeline->gate = gate.get_future().share();
+
+    // First update is blocked in prepare, second one is queued and superseded by the third one
+    for (int iUpdate = 0; iUpdate < 3; iUpdate++)
+    {
+      manager->SchedulePipelineUpdate(pipeline);
+    }
+    QCOMPARE(manager->GetNumberOfPendingUpdates(), 3);
+
+    gate.set_value();
+    manager->WaitForPipelineUpdates();
+    QCOMPARE(pipeline->nCommitted, 1);
+    QCOMPARE(pipeline->committed.GetPointer(), pipeline->lastSnapshot.GetPointer());
+    QCOMPARE(manager->GetNumberOfCancelledUpdates(), 2);
+    QVERIFY(pipeline->nPrepared <= 2);
+  }
+
+  void testCancelledUpdatesAreNotCommitted() const
+  {
+    vtkNew<vtkMRMLLayerDMPipelineManager> manager;
+    vtkNew<AsyncPipeline> pipeline;
+    pipeline->SetPipelineManager(manager);
+
+    manager->SchedulePipelineUpdate(pipeline);
+    manager->CancelPipelineUpdate(pipeline);
+    QVERIFY(!pipeline->IsUpdatePending());
+
+    manager->WaitForPipelineUpdates();
+    QCOMPARE(pipeline->nCommitted, 0);
+    QCOMPARE(manager->GetNumberOfCancelledUpdates(), 1);
+  }
+
+  void testQueuedTasksAreDiscardedWhenThePoolIsDestroyed() const
+  {
+    auto pool = std::make_unique<layer_dm::WorkStealingThreadPool>(1);
+    std::promise<void> started;
+    std::promise<void> gate;
+    auto gateFuture = gate.get_future();
+    pool->Submit(
+      [&started, &gateFuture]
+      {
+        started.set_value();
+        gateFuture.wait();
+      });
+    started.get_future().wait();
+
+    // The running task is only released when the queued task is discarded
+    auto releaseRunningTask = std::shared_ptr<void>(nullptr, [&gate](void*) { gate.set_value(); });
+    std::atomic<bool> wasQueuedTaskRun{ false };
+    pool->Submit([&wasQueuedTaskRun, releaseRunningTask] { wasQueuedTaskRun = true; });
+    releaseRunningTask.reset();
+
+    pool.reset();
+    QVERIFY(!wasQueuedTaskRun);
+  }
+
+  void testPreparedUpdatesAreCommittedWithoutInteractor() const
+  {
+    vtkNew<vtkMRMLLayerDMPipelineManager> manager;
+    vtkNew<vtkRenderWindow> renderWindow;
+    manager->SetRenderWindow(renderWindow);
+    int nRequestedRenders = 0;
+    manager->SetRequestRender([&nRequestedRenders] { nRequestedRenders++; });
+
+    vtkNew<AsyncPipeline> pipeline;
+    pipeline->SetPipelineManager(manager);
+    std::promise<void> gate;
+    pipeline->gate = gate.get_future().share();
+
+    // No commit timer can be started, scheduling requests the render committing the update if prepared by then
+    manager->SchedulePipelineUpdate(pipeline);
+    QCOMPARE(nRequestedRenders, 1);
+
+    // Renders happening before the update is prepared don't request new renders
+    nRequestedRenders = 0;
+    renderWindow->InvokeEvent(vtkCommand::StartEvent);
+    QCOMPARE(nRequestedRenders, 0);
+    QCOMPARE(pipeline->nCommitted, 0);
+
+    // Polling from the host event loop commits the update once prepared and requests its render
+    gate.set_value();
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pipeline->nCommitted == 0 && std::chrono::steady_clock::now() < timeout)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      manager->PollCompletedPipelineUpdates();
+    }
+    QCOMPARE(pipeline->nCommitted, 1);
+    QCOMPARE(manager->GetNumberOfPendingUpdates(), 0);
+    QCOMPARE(nRequestedRenders, 1);
+  }
+};
+
+CTK_TEST_MAIN(AsyncPipelineUpdateTest)
+
+#include "AsyncPipelineUpdateTest.moc"
@@ -0,0 +1,149 @@
+// LayerDM includes
+#include "vtkMRMLLayerDMInteractionLatency.h"
+#include "vtkMRMLLayerDMLatencyHistogram.h"
+
+// VTK includes
+#include <vtkCommand.h>
+#include <vtkNew.h>
+
+// STL includes
+#include <cmath>
+#include <string>
+
+#include <ctkTest.h>
+
+namespace
+{
+/// Process an event in the input pipeline and optionally render it
+void ProcessEvent(vtkMRMLLayerDMInteractionLatency* latency, unsigned long eventType, vtkObject* pipeline, bool requestRender)
+{
+  latency->BeginEvent(eventType);
+  if (requestRender)
+  {
+    latency->OnRenderRequested();
+  }
+  latency->EndProcessing(pipeline);
+  latency->OnRenderStarted();
+}
+
+bool IsClose(double value, double expected, double relativeTolerance)
+{
+  return std::abs(value - expected) <= relativeTolerance * expected;
+}
+} // namespace
+
+class InteractionLatencyTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testHistogramPercentilesHaveBoundedRelativeError() const
+  {
+    layer_dm::LatencyHistogram histogram;
+    QCOMPARE(histogram.GetValueAtPercentile(50), 0.);
+
+    for (int iValue = 1; iValue <= 10000; iValue++)
+    {
+      histogram.RecordValue(iValue * 1e-6);
+    }
+    QCOMPARE(histogram.GetTotalCount(), std::uint64_t{ 10000 });
+    QVERIFY(IsClose(histogram.GetValueAtPercentile(50), 5000e-6, 0.035));
+    QVERIFY(IsClose(histogram.GetValueAtPercentile(99), 9900e-6, 0.035));
+    QVERIFY(IsClose(histogram.GetValueAtPercentile(100), 10000e-6, 0.035));
+
+    layer_dm::LatencyHistogram merged;
+    merged.Merge(histogram);
+    merged.Merge(histogram);
+    QCOMPARE(merged.GetTotalCount(), std::uint64_t{ 20000 });
+    QCOMPARE(merged.GetValueAtPercentile(50), histogram.GetValueAtPercentile(50));
+
+    merged.Reset();
+    QCOMPARE(merged.GetTotalCount(), std::uint64_t{ 0 });
+  }
+
+  void testDisabledRecorderDoesNotRecord() const
+  {
+    vtkNew<vtkMRMLLayerDMInteractionLatency> latency;
+    vtkNew<vtkObject> pipeline;
+    QVERIFY(!latency->IsEnabled());
+
+    ProcessEvent(latency, vtkCommand::MouseMoveEvent, pipeline, true);
+    QCOMPARE(latency->GetNumberOfLatencies(vtkMRMLLayerDMInteractionLatency::ProcessingLatency), 0);
+    QCOMPARE(latency->GetNumberOfEventTypes(), 0);
+    QCOMPARE(latency->GetNumberOfPipelineClasses(), 0);
+  }
+
+  void testLatenciesAreRecordedPerStageEventTypeAndPipelineClass() const
+  {
+    vtkNew<vtkMRMLLayerDMInteractionLatency> latency;
+    vtkNew<vtkObject> pipeline;
+    latency->SetEnabled(true);
+
+    ProcessEvent(latency, vtkCommand::MouseMoveEvent, pipeline, true);
+    ProcessEvent(latency, vtkCommand::MouseMoveEvent, pipeline, false);
+    ProcessEvent(latency, vtkCommand::LeftButtonPressEvent, pipeline, true);
+
+    // Events entering the displayable manager without being processed are not recorded
+    latency->BeginEvent(vtkCommand::KeyPressEvent);
+    latency->OnRenderStarted();
+
+    using Latency = vtkMRMLLayerDMInteractionLatency;
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency), 3);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency, vtkCommand::MouseMoveEvent), 2);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency, 0, "vtkObject"), 3);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency, 0, "OtherPipeline"), 0);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::RenderLatency), 2);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::RenderLatency, vtkCommand::MouseMoveEvent), 1);
+
+    QCOMPARE(latency->GetNumberOfEventTypes(), 2);
+    QCOMPARE(latency->GetNthEventType(0), static_cast<unsigned long>(vtkCommand::MouseMoveEvent));
+    QCOMPARE(latency->GetNumberOfPipelineClasses(), 1);
+    QCOMPARE(std::string(latency->GetNthPipelineClass(0)), std::string("vtkObject"));
+    QVERIFY(latency->GetLatencyPercentile(Latency::ProcessingLatency, 99) >= 0);
+    QVERIFY(latency->GetLatencyReport().find("Processing MouseMoveEvent vtkObject: count=2") != std::string::npos);
+
+    latency->Reset();
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency), 0);
+    QCOMPARE(latency->GetNumberOfEventTypes(), 0);
+    QVERIFY(latency->GetLatencyReport().empty());
+  }
+
+  void testOnlyEventsRequestingARenderRecordTheRenderLatency() const
+  {
+    vtkNew<vtkMRMLLayerDMInteractionLatency> latency;
+    vtkNew<vtkObject> pipeline;
+    latency->SetEnabled(true);
+
+    // Both events are processed before the same render, only the first one requested it
+    latency->BeginEvent(vtkCommand::LeftButtonPressEvent);
+    latency->OnRenderRequested();
+    latency->EndProcessing(pipeline);
+    latency->BeginEvent(vtkCommand::MouseMoveEvent);
+    latency->EndProcessing(pipeline);
+
+    // Render requested outside of the event processing
+    latency->OnRenderRequested();
+    latency->OnRenderStarted();
+
+    using Latency = vtkMRMLLayerDMInteractionLatency;
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::ProcessingLatency), 2);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::RenderLatency), 1);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::RenderLatency, vtkCommand::LeftButtonPressEvent), 1);
+    QCOMPARE(latency->GetNumberOfLatencies(Latency::RenderLatency, vtkCommand::MouseMoveEvent), 0);
+  }
+
+  void benchmarkRecordProcessedEvent() const
+  {
+    vtkNew<vtkMRMLLayerDMInteractionLatency> latency;
+    vtkNew<vtkObject> pipeline;
+    latency->SetEnabled(true);
+    QBENCHMARK
+    {
+      ProcessEvent(latency, vtkCommand::MouseMoveEvent, pipeline, true);
+    }
+  }
+};
+
+CTK_TEST_MAIN(InteractionLatencyTest)
+
+#include "InteractionLatencyTest.moc"
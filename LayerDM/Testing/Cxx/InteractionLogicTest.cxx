@@ -0,0 +1,333 @@
+// LayerDM includes
+#include "AllocationCounter.h"
+#include "vtkMRMLLayerDMInteractionLogic.h"
+#include "vtkMRMLLayerDMPipelineI.h"
+
+// Slicer includes
+#include <vtkMRMLAbstractWidget.h>
+#include <vtkMRMLInteractionEventData.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+
+// STL includes
+#include <algorithm>
+#include <vector>
+
+#include <ctkTest.h>
+
+namespace
+{
+/// Pipeline picked when the event world position is inside its sphere
+class PickablePipeline : public vtkMRMLLayerDMPipelineI
+{
+public:
+  static PickablePipeline* New();
+  vtkTypeMacro(PickablePipeline, vtkMRMLLayerDMPipelineI);
+
+  bool CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2) override
+  {
+    double position[3];
+    eventData->GetWorldPosition(position);
+    distance2 = 0;
+    for (int iDim = 0; iDim < 3; iDim++)
+    {
+      distance2 += (position[iDim] - center[iDim]) * (position[iDim] - center[iDim]);
+    }
+    return distance2 <= radius * radius;
+  }
+
+  bool ProcessInteractionEvent(vtkMRMLInteractionEventData* eventData) override
+  {
+    nProcessed++;
+    return true;
+  }
+
+  unsigned int GetRenderOrder() const override { return renderOrder; }
+  vtkCamera* GetCustomCamera() const override { return customCamera; }
+  int GetWidgetState() const override { return widgetState; }
+
+  void SetCenter(double x, double y, double z, bool withBounds)
+  {
+    center[0] = x;
+    center[1] = y;
+    center[2] = z;
+    if (withBounds)
+    {
+      const double bounds[6] = { x - radius, x + radius, y - radius, y + radius, z - radius, z + radius };
+      this->SetWorldInteractionBounds(bounds);
+    }
+  }
+
+  double center[3]{};
+  double radius{ 1 };
+  unsigned int renderOrder{ 0 };
+  int widgetState{ vtkMRMLAbstractWidget::WidgetStateIdle };
+  int nProcessed{ 0 };
+  vtkSmartPointer<vtkCamera> customCamera;
+
+protected:
+  PickablePipeline() = default;
+  ~PickablePipeline() override = default;
+};
+
+vtkStandardNewMacro(PickablePipeline);
+
+struct Test
+{
+  /// Pipelines are placed on a line with overlapping spheres of a slice view
+  explicit Test(int nPipelines, bool withBounds)
+  {
+    logic->SetViewNode(sliceNode);
+    for (int iPipeline = 0; iPipeline < nPipelines; iPipeline++)
+    {
+      pipelines.emplace_back(vtkSmartPointer<PickablePipeline>::New());
+      pipelines.back()->SetCenter(iPipeline, 0, 0, withBounds);
+      pipelines.back()->renderOrder = static_cast<unsigned int>(iPipeline % 3);
+      logic->AddPipeline(pipelines.back());
+    }
+    eventData->SetType(vtkCommand::MouseMoveEvent);
+  }
+
+  /// Dispatch a mouse move at the input world position through the interaction logic
+  bool MouseMove(double x)
+  {
+    const double position[3] = { x, 0, 0 };
+    eventData->SetWorldPosition(position);
+    double distance2;
+    return logic->CanProcessInteractionEvent(eventData, distance2) && logic->ProcessInteractionEvent(eventData);
+  }
+
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  vtkNew<vtkMRMLLayerDMInteractionLogic> logic;
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+  std::vector<vtkSmartPointer<PickablePipeline>> pipelines;
+};
+
+/// 3D view looking at the origin along -Z. The test events are at the center of the view.
+struct ThreeDView
+{
+  explicit ThreeDView(Test& test)
+  {
+    renderWindow->SetSize(100, 100);
+    renderWindow->AddRenderer(renderer);
+    renderer->GetActiveCamera()->SetPosition(0, 0, 200);
+    renderer->GetActiveCamera()->SetFocalPoint(0, 0, 0);
+    renderer->GetActiveCamera()->SetClippingRange(1, 400);
+    const int displayPosition[2] = { 50, 50 };
+    test.logic->SetViewNode(viewNode);
+    test.eventData->SetRenderer(renderer);
+    test.eventData->SetDisplayPosition(displayPosition);
+  }
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  vtkNew<vtkRenderWindow> renderWindow;
+  vtkNew<vtkRenderer> renderer;
+};
+
+constexpr int BenchmarkPipelines = 1000;
+} // namespace
+
+class InteractionLogicTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testHighestPriorityCandidateIsTheOnlyOneProcessing() const
+  {
+    Test test(3, false);
+    test.pipelines[0]->renderOrder = 1;
+    test.pipelines[1]->renderOrder = 10;
+    test.pipelines[2]->renderOrder = 5;
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipeline->SetCenter(0, 0, 0, false);
+    }
+
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfCanProcessPipelines(), 3);
+    QCOMPARE(test.logic->GetLastFocusedPipeline(), test.pipelines[1].GetPointer());
+    QCOMPARE(test.pipelines[0]->nProcessed, 0);
+    QCOMPARE(test.pipelines[1]->nProcessed, 1);
+    QCOMPARE(test.pipelines[2]->nProcessed, 0);
+  }
+
+  void testActiveFocusedPipelineIsPolledAlone() const
+  {
+    Test test(BenchmarkPipelines, false);
+    QVERIFY(test.MouseMove(-0.5));
+    auto focused = test.pipelines[0];
+    QCOMPARE(test.logic->GetLastFocusedPipeline(), focused.GetPointer());
+
+    // Dragging far from the other pipelines keeps the focus and only polls the focused pipeline
+    focused->widgetState = vtkMRMLAbstractWidget::WidgetStateTranslate;
+    focused->radius = BenchmarkPipelines;
+    QVERIFY(test.MouseMove(BenchmarkPipelines / 2.));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 1);
+    QCOMPARE(test.logic->GetLastFocusedPipeline(), focused.GetPointer());
+
+    // Back to idle, all the pipelines around the event are polled again
+    focused->widgetState = vtkMRMLAbstractWidget::WidgetStateIdle;
+    QVERIFY(test.MouseMove(BenchmarkPipelines / 2.));
+    QVERIFY(test.logic->GetNumberOfPolledPipelines() > 1);
+  }
+
+  void testConcurrentPollingMatchesSequentialPolling() const
+  {
+    // Half of the pipelines are reentrant and polled on the workers, the other half on the main thread
+    Test sequential(BenchmarkPipelines, false);
+    Test concurrent(BenchmarkPipelines, false);
+    for (int iPipeline = 0; iPipeline < BenchmarkPipelines; iPipeline += 2)
+    {
+      concurrent.pipelines[iPipeline]->SetReentrantCanProcessInteractionEvent(true);
+    }
+    sequential.logic->SetConcurrentPollingThreshold(0);
+    concurrent.logic->SetConcurrentPollingThreshold(1);
+    concurrent.logic->SetNumberOfPollingThreads(4);
+
+    const auto indexOf = [](const Test& test, vtkMRMLLayerDMPipelineI* pipeline)
+    { return std::find(test.pipelines.begin(), test.pipelines.end(), pipeline) - test.pipelines.begin(); };
+
+    for (int iMove = 0; iMove < 100; iMove++)
+    {
+      const double x = iMove * 7.25;
+      QCOMPARE(concurrent.MouseMove(x), sequential.MouseMove(x));
+      QCOMPARE(concurrent.logic->GetNumberOfPolledPipelines(), BenchmarkPipelines);
+      QCOMPARE(concurrent.logic->GetNumberOfConcurrentlyPolledPipelines(), BenchmarkPipelines / 2);
+      QCOMPARE(sequential.logic->GetNumberOfConcurrentlyPolledPipelines(), 0);
+      QCOMPARE(concurrent.logic->GetNumberOfCanProcessPipelines(), sequential.logic->GetNumberOfCanProcessPipelines());
+      QCOMPARE(indexOf(concurrent, concurrent.logic->GetLastFocusedPipeline()), indexOf(sequential, sequential.logic->GetLastFocusedPipeline()));
+      for (int iCanProcess = 0; iCanProcess < sequential.logic->GetNumberOfCanProcessPipelines(); iCanProcess++)
+      {
+        QCOMPARE(indexOf(concurrent, concurrent.logic->GetNthCanProcessPipeline(iCanProcess)),
+                 indexOf(sequential, sequential.logic->GetNthCanProcessPipeline(iCanProcess)));
+      }
+    }
+
+    // Below the threshold, the reentrant pipelines are polled on the main thread
+    concurrent.logic->SetConcurrentPollingThreshold(BenchmarkPipelines);
+    QVERIFY(concurrent.MouseMove(0.5));
+    QCOMPARE(concurrent.logic->GetNumberOfConcurrentlyPolledPipelines(), 0);
+  }
+
+  void testMouseMoveDoesNotAllocate() const
+  {
+    for (bool withBounds : { false, true })
+    {
+      Test test(BenchmarkPipelines, withBounds);
+
+      // First event builds the interaction hierarchies and grows the scratch buffers
+      QVERIFY(test.MouseMove(0.5));
+
+      const auto nAllocationsBefore = layer_dm::GetNumberOfAllocations();
+      for (int iMove = 0; iMove < 100; iMove++)
+      {
+        QVERIFY(test.MouseMove(iMove + 0.5));
+      }
+      QCOMPARE(layer_dm::GetNumberOfAllocations() - nAllocationsBefore, 0LL);
+    }
+  }
+
+  void testWorldBoundsAreTestedAlongThePickRayInThreeDViews() const
+  {
+    // Pipeline reaching the picked surface from the front of it and pipeline beside the pick ray
+    Test test(2, true);
+    test.pipelines[0]->radius = 60;
+    test.pipelines[0]->SetCenter(0, 0, 50, true);
+    test.pipelines[1]->SetCenter(20, 0, 0, true);
+    vtkNew<vtkMRMLViewNode> viewNode;
+    test.logic->SetViewNode(viewNode);
+
+    // Without renderer the pick ray is unknown, all the world bounded pipelines are polled
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 2);
+
+    // Only the pipeline crossed by the ray is polled
+    ThreeDView view(test);
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 1);
+    QCOMPARE(test.logic->GetLastFocusedPipeline(), test.pipelines[0].GetPointer());
+  }
+
+  void testCustomCameraPipelinesAreNotCulledByThePickRay() const
+  {
+    // Second pipeline is beside the default camera pick ray
+    Test test(2, true);
+    test.pipelines[0]->SetCenter(0, 0, 0, true);
+    test.pipelines[1]->SetCenter(20, 0, 0, true);
+    ThreeDView view(test);
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 1);
+
+    // Its bounds are in the frame of its custom camera and cannot be tested against the default camera ray
+    test.pipelines[1]->customCamera = vtkSmartPointer<vtkCamera>::New();
+    test.logic->UpdatePipelineCustomCamera(test.pipelines[1]);
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 2);
+
+    // Back to the default camera, the pipeline is culled again
+    test.pipelines[1]->customCamera = nullptr;
+    test.logic->UpdatePipelineCustomCamera(test.pipelines[1]);
+    QVERIFY(test.MouseMove(0));
+    QCOMPARE(test.logic->GetNumberOfPolledPipelines(), 1);
+  }
+
+  void benchmarkMouseMove() const
+  {
+    Test test(BenchmarkPipelines, false);
+    int iMove = 0;
+    QBENCHMARK
+    {
+      test.MouseMove((iMove++ % BenchmarkPipelines) + 0.5);
+    }
+  }
+
+  void benchmarkDragMouseMove() const
+  {
+    Test test(BenchmarkPipelines, false);
+    QVERIFY(test.MouseMove(-0.5));
+    test.pipelines[0]->widgetState = vtkMRMLAbstractWidget::WidgetStateTranslate;
+    test.pipelines[0]->radius = BenchmarkPipelines;
+    int iMove = 0;
+    QBENCHMARK
+    {
+      test.MouseMove((iMove++ % BenchmarkPipelines) + 0.5);
+    }
+  }
+
+  void benchmarkMouseMoveWithConcurrentPolling() const
+  {
+    Test test(BenchmarkPipelines, false);
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipeline->SetReentrantCanProcessInteractionEvent(true);
+    }
+    int iMove = 0;
+    QBENCHMARK
+    {
+      test.MouseMove((iMove++ % BenchmarkPipelines) + 0.5);
+    }
+  }
+
+  void benchmarkMouseMoveWithInteractionBounds() const
+  {
+    Test test(BenchmarkPipelines, true);
+    int iMove = 0;
+    QBENCHMARK
+    {
+      test.MouseMove((iMove++ % BenchmarkPipelines) + 0.5);
+    }
+  }
+};
+
+CTK_TEST_MAIN(InteractionLogicTest)
+
+#include "InteractionLogicTest.moc"
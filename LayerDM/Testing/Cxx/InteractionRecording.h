@@ -0,0 +1,297 @@
+#pragma once
+
+// Slicer includes
+#include <vtkMRMLAbstractViewNode.h>
+#include <vtkMRMLInteractionEventData.h>
+
+// STL includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace layer_dm
+{
+/// \brief Stream of interaction events which can be written to / read from a compact binary file.
+///
+/// The event type, display / world positions, modifiers, key code / repeat count / sym and view node ID of the events
+/// are recorded. View node IDs are stored once in a table and referenced by index by the events.
+///
+/// File layout (native endianness) :
+///   - Header : magic "LDMI", uint32 version, uint32 number of views, uint32 number of events
+///   - Views : uint8 ID length + ID characters
+///   - Events : uint32 type, uint8 flags (display / world position validity), int32[2] display position,
+///     double[3] world position (only if valid), uint8 modifiers, int8 key code, uint8 key repeat count,
+///     uint8 key sym length + key sym characters, uint8 view index
+///
+/// Recording can be done from any C++ code having access to the interaction event data (for instance a debug build of
+/// \sa vtkMRMLLayerDisplayableManager::CanProcessInteractionEvent).
+class InteractionRecording
+{
+public:
+  struct Event
+  {
+    unsigned long Type{ 0 };
+    bool IsDisplayPositionValid{ false };
+    bool IsWorldPositionValid{ false };
+    int DisplayPosition[2]{};
+    double WorldPosition[3]{};
+    int Modifiers{ 0 };
+    char KeyCode{ 0 };
+    int KeyRepeatCount{ 0 };
+    std::string KeySym;
+    int ViewIndex{ -1 };
+  };
+
+  /// Append the input event data to the recording
+  void Record(vtkMRMLInteractionEventData* eventData)
+  {
+    Event event;
+    event.Type = eventData->GetType();
+    event.IsDisplayPositionValid = eventData->IsDisplayPositionValid();
+    event.IsWorldPositionValid = eventData->IsWorldPositionValid();
+    eventData->GetDisplayPosition(event.DisplayPosition);
+    eventData->GetWorldPosition(event.WorldPosition);
+    event.Modifiers = eventData->GetModifiers();
+    event.KeyCode = eventData->GetKeyCode();
+    event.KeyRepeatCount = eventData->GetKeyRepeatCount();
+    event.KeySym = eventData->GetKeySym();
+    event.ViewIndex = this->GetViewIndex(eventData->GetViewNode());
+    this->m_events.emplace_back(std::move(event));
+  }
+
+  /// Copy the recorded event into the input event data. The view node is left unchanged.
+  void Apply(int iEvent, vtkMRMLInteractionEventData* eventData) const
+  {
+    const auto& event = this->m_events[iEvent];
+    eventData->SetType(event.Type);
+    if (event.IsDisplayPositionValid)
+    {
+      eventData->SetDisplayPosition(event.DisplayPosition);
+    }
+    if (event.IsWorldPositionValid)
+    {
+      eventData->SetWorldPosition(event.WorldPosition);
+    }
+    eventData->SetModifiers(event.Modifiers);
+    eventData->SetKeyCode(event.KeyCode);
+    eventData->SetKeyRepeatCount(event.KeyRepeatCount);
+    eventData->SetKeySym(event.KeySym);
+  }
+
+  int GetNumberOfEvents() const { return static_cast<int>(this->m_events.size()); }
+  const Event& GetEvent(int iEvent) const { return this->m_events[iEvent]; }
+
+  /// Returns the view node ID of the input event or an empty string if the event had no view node
+  std::string GetViewID(int iEvent) const
+  {
+    const int iView = this->m_events[iEvent].ViewIndex;
+    return iView < 0 ? std::string{} : this->m_viewIDs[iView];
+  }
+
+  void Clear()
+  {
+    this->m_events.clear();
+    this->m_viewIDs.clear();
+  }
+
+  /// Write the recording to the input path. Returns false if the file couldn't be written.
+  bool Write(const std::string& path) const
+  {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      return false;
+    }
+
+    file.write(Magic, sizeof(Magic));
+    WriteValue<std::uint32_t>(file, Version);
+    WriteValue<std::uint32_t>(file, static_cast<std::uint32_t>(this->m_viewIDs.size()));
+    WriteValue<std::uint32_t>(file, static_cast<std::uint32_t>(this->m_events.size()));
+    for (const auto& viewID : this->m_viewIDs)
+    {
+      WriteString(file, viewID);
+    }
+
+    for (const auto& event : this->m_events)
+    {
+      WriteValue<std::uint32_t>(file, static_cast<std::uint32_t>(event.Type));
+      WriteValue<std::uint8_t>(file, (event.IsDisplayPositionValid ? DisplayPositionFlag : 0) | (event.IsWorldPositionValid ? WorldPositionFlag : 0));
+      WriteValue<std::int32_t>(file, event.DisplayPosition[0]);
+      WriteValue<std::int32_t>(file, event.DisplayPosition[1]);
+      if (event.IsWorldPositionValid)
+      {
+        file.write(reinterpret_cast<const char*>(event.WorldPosition), sizeof(event.WorldPosition));
+      }
+      WriteValue<std::uint8_t>(file, static_cast<std::uint8_t>(event.Modifiers));
+      WriteValue<std::int8_t>(file, static_cast<std::int8_t>(event.KeyCode));
+      WriteValue<std::uint8_t>(file, static_cast<std::uint8_t>(std::min(event.KeyRepeatCount, 255)));
+      WriteString(file, event.KeySym);
+      WriteValue<std::uint8_t>(file, static_cast<std::uint8_t>(event.ViewIndex < 0 ? NoView : event.ViewIndex));
+    }
+    return static_cast<bool>(file);
+  }
+
+  /// Replace the recording with the content of the input path. Returns false if the file couldn't be read.
+  bool Read(const std::string& path)
+  {
+    this->Clear();
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::vector<char> buffer{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    Reader reader{ buffer };
+
+    char magic[sizeof(Magic)]{};
+    std::uint32_t version{}, nViews{}, nEvents{};
+    if (!reader.ReadBytes(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0 || !reader.Read(version) ||
+        version != Version || !reader.Read(nViews) || !reader.Read(nEvents))
+    {
+      return false;
+    }
+
+    // Counts of corrupted files are rejected before allocating the entries
+    if (nViews > reader.GetRemainingSize() / MinViewSize)
+    {
+      return false;
+    }
+
+    this->m_viewIDs.resize(nViews);
+    for (auto& viewID : this->m_viewIDs)
+    {
+      if (!reader.ReadString(viewID))
+      {
+        this->Clear();
+        return false;
+      }
+    }
+
+    if (nEvents > reader.GetRemainingSize() / MinEventSize)
+    {
+      this->Clear();
+      return false;
+    }
+
+    this->m_events.resize(nEvents);
+    for (auto& event : this->m_events)
+    {
+      std::uint32_t type{};
+      std::uint8_t flags{}, modifiers{}, keyRepeatCount{}, viewIndex{};
+      std::int8_t keyCode{};
+      std::int32_t displayPosition[2]{};
+      bool isValid = reader.Read(type) && reader.Read(flags) && reader.Read(displayPosition[0]) && reader.Read(displayPosition[1]);
+      if (isValid && (flags & WorldPositionFlag))
+      {
+        isValid = reader.ReadBytes(reinterpret_cast<char*>(event.WorldPosition), sizeof(event.WorldPosition));
+      }
+      isValid = isValid && reader.Read(modifiers) && reader.Read(keyCode) && reader.Read(keyRepeatCount) && reader.ReadString(event.KeySym) &&
+                reader.Read(viewIndex) && (viewIndex == NoView || viewIndex < nViews);
+      if (!isValid)
+      {
+        this->Clear();
+        return false;
+      }
+
+      event.Type = type;
+      event.IsDisplayPositionValid = flags & DisplayPositionFlag;
+      event.IsWorldPositionValid = flags & WorldPositionFlag;
+      event.DisplayPosition[0] = displayPosition[0];
+      event.DisplayPosition[1] = displayPosition[1];
+      event.Modifiers = modifiers;
+      event.KeyCode = static_cast<char>(keyCode);
+      event.KeyRepeatCount = keyRepeatCount;
+      event.ViewIndex = viewIndex == NoView ? -1 : viewIndex;
+    }
+    return true;
+  }
+
+private:
+  static constexpr char Magic[4] = { 'L', 'D', 'M', 'I' };
+  static constexpr std::uint32_t Version = 1;
+  static constexpr std::uint8_t DisplayPositionFlag = 1;
+  static constexpr std::uint8_t WorldPositionFlag = 2;
+  static constexpr std::uint8_t NoView = 255;
+
+  /// Serialized sizes of a view ID and of an event with empty strings and without world position
+  static constexpr std::size_t MinViewSize = 1;
+  static constexpr std::size_t MinEventSize = 18;
+
+  /// Bounds checked reader of the file content
+  struct Reader
+  {
+    bool ReadBytes(char* data, std::size_t size)
+    {
+      if (Offset + size > Buffer.size())
+      {
+        return false;
+      }
+      std::memcpy(data, Buffer.data() + Offset, size);
+      Offset += size;
+      return true;
+    }
+
+    std::size_t GetRemainingSize() const { return Buffer.size() - Offset; }
+
+    template <typename T>
+    bool Read(T& value)
+    {
+      return this->ReadBytes(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    bool ReadString(std::string& value)
+    {
+      std::uint8_t size{};
+      if (!this->Read(size) || Offset + size > Buffer.size())
+      {
+        return false;
+      }
+      value.assign(Buffer.data() + Offset, size);
+      Offset += size;
+      return true;
+    }
+
+    const std::vector<char>& Buffer;
+    std::size_t Offset{ 0 };
+  };
+
+  template <typename T>
+  static void WriteValue(std::ofstream& file, T value)
+  {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /// Strings longer than 255 characters are truncated
+  static void WriteString(std::ofstream& file, const std::string& value)
+  {
+    const auto size = static_cast<std::uint8_t>(std::min<std::size_t>(value.size(), 255));
+    WriteValue(file, size);
+    file.write(value.data(), size);
+  }
+
+  int GetViewIndex(vtkMRMLAbstractViewNode* viewNode)
+  {
+    if (!viewNode || !viewNode->GetID())
+    {
+      return -1;
+    }
+
+    const auto viewID = std::find(this->m_viewIDs.begin(), this->m_viewIDs.end(), viewNode->GetID());
+    if (viewID != this->m_viewIDs.end())
+    {
+      return static_cast<int>(std::distance(this->m_viewIDs.begin(), viewID));
+    }
+
+    // Last index is reserved for the events without view
+    if (this->m_viewIDs.size() >= NoView)
+    {
+      return -1;
+    }
+    this->m_viewIDs.emplace_back(viewNode->GetID());
+    return static_cast<int>(this->m_viewIDs.size()) - 1;
+  }
+
+  std::vector<Event> m_events;
+  std::vector<std::string> m_viewIDs;
+};
+} // namespace layer_dm
@@ -0,0 +1,456 @@
+// LayerDM includes
+#include "AllocationCounter.h"
+#include "InteractionRecording.h"
+#include "vtkMRMLLayerDMPipelineCallbackCreator.h"
+#include "vtkMRMLLayerDMPipelineFactory.h"
+#include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMPipelineManager.h"
+
+// Slicer includes
+#include <vtkMRMLAbstractWidget.h>
+#include <vtkMRMLInteractionEventData.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLScriptedModuleNode.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+// Qt includes
+#include <QTemporaryDir>
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ctkTest.h>
+
+namespace
+{
+/// Pipeline picked when the event world position is inside its sphere.
+/// Left button press starts dragging the sphere until the button is released or the pipeline loses focus.
+class SyntheticPipeline : public vtkMRMLLayerDMPipelineI
+{
+public:
+  static SyntheticPipeline* New();
+  vtkTypeMacro(SyntheticPipeline, vtkMRMLLayerDMPipelineI);
+
+  bool CanProcessInteractionEvent(vtkMRMLInteractionEventData* eventData, double& distance2) override
+  {
+    if (!eventData->IsWorldPositionValid())
+    {
+      return false;
+    }
+
+    const double* position = eventData->GetWorldPosition();
+    distance2 = 0;
+    for (int iDim = 0; iDim < 3; iDim++)
+    {
+      distance2 += (position[iDim] - center[iDim]) * (position[iDim] - center[iDim]);
+    }
+    return widgetState == vtkMRMLAbstractWidget::WidgetStateTranslate || distance2 <= radius * radius;
+  }
+
+  bool ProcessInteractionEvent(vtkMRMLInteractionEventData* eventData) override
+  {
+    switch (eventData->GetType())
+    {
+      case vtkCommand::LeftButtonPressEvent: widgetState = vtkMRMLAbstractWidget::WidgetStateTranslate; break;
+      case vtkCommand::LeftButtonReleaseEvent: widgetState = vtkMRMLAbstractWidget::WidgetStateOnWidget; break;
+      case vtkCommand::MouseMoveEvent:
+        if (widgetState == vtkMRMLAbstractWidget::WidgetStateTranslate)
+        {
+          const double* position = eventData->GetWorldPosition();
+          this->SetCenter(position[0], position[1], position[2]);
+        }
+        else
+        {
+          widgetState = vtkMRMLAbstractWidget::WidgetStateOnWidget;
+        }
+        break;
+      default: return false;
+    }
+    return true;
+  }
+
+  void LoseFocus(vtkMRMLInteractionEventData* eventData) override { widgetState = vtkMRMLAbstractWidget::WidgetStateIdle; }
+
+  int GetWidgetState() const override { return widgetState; }
+
+  void SetCenter(double x, double y, double z)
+  {
+    center[0] = x;
+    center[1] = y;
+    center[2] = z;
+    const double bounds[6] = { x - radius, x + radius, y - radius, y + radius, z - radius, z + radius };
+    this->SetWorldInteractionBounds(bounds);
+  }
+
+  double center[3]{};
+  double radius{ 1 };
+  int widgetState{ vtkMRMLAbstractWidget::WidgetStateIdle };
+
+protected:
+  SyntheticPipeline() = default;
+  ~SyntheticPipeline() override = default;
+};
+
+vtkStandardNewMacro(SyntheticPipeline);
+
+/// Replayed interaction hot path stages
+enum ReplayStage
+{
+  CanProcessStage = 0,
+  ProcessStage,
+  LoseFocusStage,
+  NumberOfReplayStages
+};
+
+const char* GetReplayStageName(int stage)
+{
+  switch (stage)
+  {
+    case CanProcessStage: return "CanProcessInteractionEvent";
+    case ProcessStage: return "ProcessInteractionEvent";
+    case LoseFocusStage: return "LoseFocus";
+    default: return "";
+  }
+}
+
+struct ReplayStatistics
+{
+  int NumberOfEvents{ 0 };
+  int NumberOfProcessedEvents{ 0 };
+  double TotalSeconds{ 0 };
+  long long NumberOfAllocations{ 0 };
+  std::array<int, NumberOfReplayStages> StageCalls{};
+  std::array<double, NumberOfReplayStages> StageSeconds{};
+
+  double GetEventsPerSecond() const { return TotalSeconds > 0 ? NumberOfEvents / TotalSeconds : 0; }
+
+  void Report() const
+  {
+    qInfo("Replayed %d events (%d processed) in %.3f ms: %.0f events/s, %lld allocations", NumberOfEvents, NumberOfProcessedEvents,
+          TotalSeconds * 1e3, GetEventsPerSecond(), NumberOfAllocations);
+    for (int iStage = 0; iStage < NumberOfReplayStages; iStage++)
+    {
+      qInfo("  %s: %d calls, %.3f ms total, %.3f us / call", GetReplayStageName(iStage), StageCalls[iStage], StageSeconds[iStage] * 1e3,
+            StageCalls[iStage] ? StageSeconds[iStage] * 1e6 / StageCalls[iStage] : 0.);
+    }
+  }
+};
+
+/// Headless slice view populated with synthetic pipelines laid out on a grid.
+/// The pipelines are created by the pipeline factory from scripted module nodes as in a Slicer view.
+struct ReplayView
+{
+  ReplayView(int nPipelines, const double bounds[6])
+  {
+    scene->AddNode(viewNode);
+    manager->SetScene(scene);
+    manager->SetViewNode(viewNode);
+
+    // Overlapping spheres filling the input bounds, flat bounds dimensions have a single row of spheres
+    int nDims = 0;
+    for (int iDim = 0; iDim < 3; iDim++)
+    {
+      nDims += bounds[2 * iDim + 1] > bounds[2 * iDim] ? 1 : 0;
+    }
+    const int nPerAxis = nDims ? static_cast<int>(std::ceil(std::pow(nPipelines, 1. / nDims) - 1e-9)) : 1;
+    std::array<int, 3> counts;
+    std::array<double, 3> spacing;
+    std::array<double, 3> origin;
+    for (int iDim = 0; iDim < 3; iDim++)
+    {
+      counts[iDim] = bounds[2 * iDim + 1] > bounds[2 * iDim] ? nPerAxis : 1;
+      spacing[iDim] = (bounds[2 * iDim + 1] - bounds[2 * iDim]) / counts[iDim];
+      origin[iDim] = bounds[2 * iDim] + 0.5 * spacing[iDim];
+    }
+    const double radius = 0.75 * std::max({ spacing[0], spacing[1], spacing[2], 1e-3 });
+
+    creator->SetCallback(
+      [=, iPipeline = 0](vtkMRMLAbstractViewNode*, vtkMRMLNode* node) mutable -> vtkSmartPointer<vtkMRMLLayerDMPipelineI>
+      {
+        if (!vtkMRMLScriptedModuleNode::SafeDownCast(node))
+        {
+          return nullptr;
+        }
+
+        const int index[3] = { iPipeline % counts[0], (iPipeline / counts[0]) % counts[1], (iPipeline / (counts[0] * counts[1])) % counts[2] };
+        iPipeline++;
+        auto pipeline = vtkSmartPointer<SyntheticPipeline>::New();
+        pipeline->radius = radius;
+        pipeline->SetCenter(origin[0] + index[0] * spacing[0], origin[1] + index[1] * spacing[1], origin[2] + index[2] * spacing[2]);
+        return pipeline;
+      });
+    factory->AddPipelineCreator(creator);
+
+    scene->StartState(vtkMRMLScene::BatchProcessState);
+    for (int iNode = 0; iNode < nPipelines; iNode++)
+    {
+      scene->AddNode(vtkSmartPointer<vtkMRMLScriptedModuleNode>::New());
+    }
+    scene->EndState(vtkMRMLScene::BatchProcessState);
+    manager->SetFactory(factory);
+  }
+
+  /// Replay the events of the input view ID (all events if empty) as dispatched by the view interactor to the
+  /// displayable manager : events not processable by the view make the focused pipeline lose focus.
+  ReplayStatistics Replay(const layer_dm::InteractionRecording& recording, const std::string& viewID = {})
+  {
+    using Clock = std::chrono::steady_clock;
+    ReplayStatistics statistics;
+    eventData->SetViewNode(viewNode);
+
+    const auto timeStage = [&statistics](int stage, auto&& call)
+    {
+      const auto start = Clock::now();
+      const auto result = call();
+      statistics.StageSeconds[stage] += std::chrono::duration<double>(Clock::now() - start).count();
+      statistics.StageCalls[stage]++;
+      return result;
+    };
+
+    bool hasFocus = false;
+    const auto nAllocationsBefore = layer_dm::GetNumberOfAllocations();
+    const auto replayStart = Clock::now();
+    for (int iEvent = 0; iEvent < recording.GetNumberOfEvents(); iEvent++)
+    {
+      if (!viewID.empty() && recording.GetViewID(iEvent) != viewID)
+      {
+        continue;
+      }
+
+      recording.Apply(iEvent, eventData);
+      statistics.NumberOfEvents++;
+      double distance2;
+      if (timeStage(CanProcessStage, [&] { return manager->CanProcessInteractionEvent(eventData, distance2); }))
+      {
+        hasFocus = true;
+        statistics.NumberOfProcessedEvents += timeStage(ProcessStage, [&] { return manager->ProcessInteractionEvent(eventData); });
+      }
+      else if (hasFocus)
+      {
+        hasFocus = false;
+        timeStage(LoseFocusStage,
+                  [&]
+                  {
+                    manager->LoseFocus(eventData);
+                    return true;
+                  });
+      }
+    }
+    statistics.TotalSeconds = std::chrono::duration<double>(Clock::now() - replayStart).count();
+    statistics.NumberOfAllocations = layer_dm::GetNumberOfAllocations() - nAllocationsBefore;
+    return statistics;
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSliceNode> viewNode;
+  vtkSmartPointer<vtkMRMLLayerDMPipelineFactory> factory{ vtkSmartPointer<vtkMRMLLayerDMPipelineFactory>::New() };
+  vtkSmartPointer<vtkMRMLLayerDMPipelineCallbackCreator> creator{ vtkSmartPointer<vtkMRMLLayerDMPipelineCallbackCreator>::New() };
+  vtkNew<vtkMRMLLayerDMPipelineManager> manager;
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+};
+
+/// Deterministic session over the [0, extent] square of the z = 0 plane.
+/// Hovers the square line by line, regularly drags the hovered sphere, presses keys and leaves / enters the view.
+layer_dm::InteractionRecording CreateSyntheticRecording(vtkMRMLAbstractViewNode* viewNode, double extent, int nEvents)
+{
+  layer_dm::InteractionRecording recording;
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+  eventData->SetViewNode(viewNode);
+
+  const auto record = [&](unsigned long type, double x, double y)
+  {
+    const double worldPosition[3] = { x, y, 0 };
+    const int displayPosition[2] = { static_cast<int>(x * 10), static_cast<int>(y * 10) };
+    eventData->SetType(type);
+    eventData->SetWorldPosition(worldPosition);
+    eventData->SetDisplayPosition(displayPosition);
+    eventData->SetKeySym(type == vtkCommand::KeyPressEvent ? "Escape" : "");
+    recording.Record(eventData);
+  };
+
+  constexpr int MovesPerLine = 200;
+  for (int iMove = 0; recording.GetNumberOfEvents() < nEvents; iMove++)
+  {
+    const double x = extent * (iMove % MovesPerLine) / MovesPerLine;
+    const double y = std::fmod(0.37 * extent * iMove / MovesPerLine, extent);
+    record(vtkCommand::MouseMoveEvent, x, y);
+    if (iMove % 100 == 50)
+    {
+      record(vtkCommand::LeftButtonPressEvent, x, y);
+      for (int iDrag = 1; iDrag <= 20; iDrag++)
+      {
+        record(vtkCommand::MouseMoveEvent, x, std::fmod(y + 0.05 * extent * iDrag / 20, extent));
+      }
+      record(vtkCommand::LeftButtonReleaseEvent, x, std::fmod(y + 0.05 * extent, extent));
+    }
+    if (iMove % 250 == 125)
+    {
+      record(vtkCommand::KeyPressEvent, x, y);
+    }
+    if (iMove % MovesPerLine == MovesPerLine - 1)
+    {
+      record(vtkCommand::LeaveEvent, x, y);
+      record(vtkCommand::EnterEvent, 0, y);
+    }
+  }
+  return recording;
+}
+
+/// Bounds of the valid world positions of the recording, [0, 1] cube if none
+void GetRecordingBounds(const layer_dm::InteractionRecording& recording, double bounds[6])
+{
+  bool isEmpty = true;
+  for (int iEvent = 0; iEvent < recording.GetNumberOfEvents(); iEvent++)
+  {
+    const auto& event = recording.GetEvent(iEvent);
+    if (!event.IsWorldPositionValid)
+    {
+      continue;
+    }
+
+    for (int iDim = 0; iDim < 3; iDim++)
+    {
+      bounds[2 * iDim] = isEmpty ? event.WorldPosition[iDim] : std::min(bounds[2 * iDim], event.WorldPosition[iDim]);
+      bounds[2 * iDim + 1] = isEmpty ? event.WorldPosition[iDim] : std::max(bounds[2 * iDim + 1], event.WorldPosition[iDim]);
+    }
+    isEmpty = false;
+  }
+
+  if (isEmpty)
+  {
+    std::fill_n(bounds, 6, 0.);
+    bounds[1] = bounds[3] = bounds[5] = 1;
+  }
+}
+
+constexpr int BenchmarkPipelines = 1000;
+constexpr int BenchmarkEvents = 10000;
+constexpr double BenchmarkExtent = 100;
+} // namespace
+
+class InteractionReplayTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testRecordingRoundTripsThroughBinaryFile() const
+  {
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkMRMLViewNode> viewNode;
+    scene->AddNode(viewNode);
+    const auto recording = CreateSyntheticRecording(viewNode, BenchmarkExtent, 1000);
+
+    QTemporaryDir dir;
+    const std::string path = dir.filePath("interaction.ldmi").toStdString();
+    QVERIFY(recording.Write(path));
+
+    layer_dm::InteractionRecording readRecording;
+    QVERIFY(readRecording.Read(path));
+    QCOMPARE(readRecording.GetNumberOfEvents(), recording.GetNumberOfEvents());
+    for (int iEvent = 0; iEvent < recording.GetNumberOfEvents(); iEvent++)
+    {
+      const auto& expected = recording.GetEvent(iEvent);
+      const auto& actual = readRecording.GetEvent(iEvent);
+      QCOMPARE(actual.Type, expected.Type);
+      QCOMPARE(actual.DisplayPosition[0], expected.DisplayPosition[0]);
+      QCOMPARE(actual.DisplayPosition[1], expected.DisplayPosition[1]);
+      QCOMPARE(actual.WorldPosition[0], expected.WorldPosition[0]);
+      QCOMPARE(actual.WorldPosition[1], expected.WorldPosition[1]);
+      QCOMPARE(actual.Modifiers, expected.Modifiers);
+      QCOMPARE(actual.KeySym, expected.KeySym);
+      QCOMPARE(readRecording.GetViewID(iEvent), std::string(viewNode->GetID()));
+    }
+
+    // Unreadable files are rejected and clear the recording
+    QVERIFY(!readRecording.Read(dir.filePath("missing.ldmi").toStdString()));
+    QCOMPARE(readRecording.GetNumberOfEvents(), 0);
+  }
+
+  void testCorruptedCountsAreRejected() const
+  {
+    QTemporaryDir dir;
+    const std::string path = dir.filePath("corrupted.ldmi").toStdString();
+    for (const auto& counts : { std::array<std::uint32_t, 2>{ 0xFFFFFFFF, 0 }, std::array<std::uint32_t, 2>{ 0, 0xFFFFFFFF } })
+    {
+      // Valid header followed by counts which don't match the truncated content
+      {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        const std::uint32_t version = 1;
+        file.write("LDMI", 4);
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        file.write(reinterpret_cast<const char*>(counts.data()), sizeof(counts));
+        file.write("\0\0\0\0", 4);
+      }
+
+      layer_dm::InteractionRecording recording;
+      QVERIFY(!recording.Read(path));
+      QCOMPARE(recording.GetNumberOfEvents(), 0);
+    }
+  }
+
+  void testReplayDispatchesEventsToThePipelines() const
+  {
+    const double bounds[6] = { 0, BenchmarkExtent, 0, BenchmarkExtent, 0, 0 };
+    ReplayView view(100, bounds);
+    QCOMPARE(view.manager->GetNumberOfPipelines(), 100);
+
+    const auto statistics = view.Replay(CreateSyntheticRecording(view.viewNode, BenchmarkExtent, 1000), view.viewNode->GetID());
+    statistics.Report();
+    QCOMPARE(statistics.NumberOfEvents, 1000);
+    QVERIFY(statistics.NumberOfProcessedEvents > 0);
+    QCOMPARE(statistics.StageCalls[CanProcessStage], 1000);
+    QVERIFY(statistics.StageCalls[LoseFocusStage] > 0);
+  }
+
+  /// Replays the recording file set in the LAYERDM_INTERACTION_RECORDING environment variable, or a synthetic session
+  /// if not set, against the benchmark pipelines.
+  void benchmarkReplay() const
+  {
+    layer_dm::InteractionRecording recording;
+    const char* recordingPath = std::getenv("LAYERDM_INTERACTION_RECORDING");
+    if (recordingPath)
+    {
+      QVERIFY(recording.Read(recordingPath));
+    }
+
+    double bounds[6] = { 0, BenchmarkExtent, 0, BenchmarkExtent, 0, 0 };
+    if (recordingPath)
+    {
+      GetRecordingBounds(recording, bounds);
+    }
+
+    ReplayView view(BenchmarkPipelines, bounds);
+    if (!recordingPath)
+    {
+      recording = CreateSyntheticRecording(view.viewNode, BenchmarkExtent, BenchmarkEvents);
+    }
+
+    // Replay the first recorded view only, events of the other views target other pipeline managers
+    const std::string viewID = recording.GetNumberOfEvents() > 0 ? recording.GetViewID(0) : std::string{};
+    ReplayStatistics statistics;
+    QBENCHMARK
+    {
+      statistics = view.Replay(recording, viewID);
+    }
+    statistics.Report();
+  }
+};
+
+CTK_TEST_MAIN(InteractionReplayTest)
+
+#include "InteractionReplayTest.moc"
@@ -0,0 +1,288 @@
+// LayerDM includes
+#include "vtkMRMLLayerDMLayerManager.h"
+#include "vtkMRMLLayerDMPipelineI.h"
+
+// VTK includes
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+
+// STL includes
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <ctkTest.h>
+
+namespace
+{
+/// Pipeline with a configurable render order counting its renderer changes.
+/// Its actor is added to / removed from its renderer on renderer changes.
+class OrderedPipeline : public vtkMRMLLayerDMPipelineI
+{
+public:
+  static OrderedPipeline* New();
+  vtkTypeMacro(OrderedPipeline, vtkMRMLLayerDMPipelineI);
+
+  unsigned int GetRenderOrder() const override { return renderOrder; }
+
+  void OnRendererAdded(vtkRenderer* renderer) override
+  {
+    nRendererChanges++;
+    if (renderer)
+    {
+      renderer->AddViewProp(actor);
+    }
+  }
+
+  void OnRendererRemoved(vtkRenderer* renderer) override
+  {
+    if (renderer)
+    {
+      renderer->RemoveViewProp(actor);
+    }
+  }
+
+  unsigned int renderOrder{ 0 };
+  int nRendererChanges{ 0 };
+  vtkNew<vtkActor> actor;
+
+protected:
+  OrderedPipeline() = default;
+  ~OrderedPipeline() override = default;
+};
+
+vtkStandardNewMacro(OrderedPipeline);
+
+struct Test
+{
+  explicit Test(int nDistinctOrders, int nPipelinesPerOrder = 1)
+  {
+    renderWindow->AddRenderer(defaultRenderer);
+    layerManager->SetRenderWindow(renderWindow);
+    layerManager->SetDefaultCamera(camera);
+
+    // Add the pipelines in shuffled order while blocked to trigger a single full update
+    for (int iOrder = 1; iOrder <= nDistinctOrders; iOrder++)
+    {
+      for (int iPipeline = 0; iPipeline < nPipelinesPerOrder; iPipeline++)
+      {
+        pipelines.emplace_back(vtkSmartPointer<OrderedPipeline>::New());
+        pipelines.back()->renderOrder = static_cast<unsigned int>(iOrder * 10);
+      }
+    }
+    std::shuffle(pipelines.begin(), pipelines.end(), std::mt19937{ 42 });
+
+    const auto wasBlocked = layerManager->BlockUpdateLayers(true);
+    for (const auto& pipeline : pipelines)
+    {
+      layerManager->AddPipeline(pipeline);
+    }
+    layerManager->BlockUpdateLayers(wasBlocked);
+  }
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  vtkNew<vtkRenderer> defaultRenderer;
+  vtkSmartPointer<vtkCamera> camera{ vtkSmartPointer<vtkCamera>::New() };
+  vtkNew<vtkMRMLLayerDMLayerManager> layerManager;
+  std::vector<vtkSmartPointer<OrderedPipeline>> pipelines;
+};
+
+/// Returns the render orders of the pipelines owning the renderer props, in the renderer props order
+std::vector<unsigned int> GetPropRenderOrders(vtkRenderer* renderer, const std::vector<OrderedPipeline*>& pipelines)
+{
+  std::vector<unsigned int> renderOrders;
+  vtkPropCollection* props = renderer->GetViewProps();
+  props->InitTraversal();
+  while (vtkProp* prop = props->GetNextProp())
+  {
+    auto owner = std::find_if(pipelines.begin(), pipelines.end(), [prop](OrderedPipeline* pipeline) { return pipeline->actor.GetPointer() == prop; });
+    if (owner != pipelines.end())
+    {
+      renderOrders.push_back((*owner)->renderOrder);
+    }
+  }
+  return renderOrders;
+}
+
+constexpr int BenchmarkDistinctOrders = 500;
+} // namespace
+
+class LayerManagerTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testRendererLayersFollowRenderOrder() const
+  {
+    Test test(300, 2);
+    QCOMPARE(test.layerManager->GetNumberOfDistinctLayers(), 301);
+    QCOMPARE(test.layerManager->GetNumberOfRenderers(), 300);
+
+    for (const auto& pipeline : test.pipelines)
+    {
+      QVERIFY(pipeline->GetRenderer());
+      QCOMPARE(static_cast<unsigned int>(pipeline->GetRenderer()->GetLayer()), pipeline->renderOrder / 10);
+    }
+  }
+
+  void testDeletedPipelinesAndTheirLayersAreRemoved() const
+  {
+    Test test(100);
+
+    // Delete every other pipeline without removing it from the layer manager
+    std::vector<vtkSmartPointer<OrderedPipeline>> remaining;
+    for (const auto& pipeline : test.pipelines)
+    {
+      if (pipeline->renderOrder % 20)
+      {
+        remaining.emplace_back(pipeline);
+      }
+    }
+    test.pipelines = remaining;
+
+    // Trigger a full update by creating a new layer
+    vtkNew<OrderedPipeline> newLayerPipeline;
+    newLayerPipeline->renderOrder = 5;
+    test.layerManager->AddPipeline(newLayerPipeline);
+
+    QCOMPARE(test.layerManager->GetNumberOfDistinctLayers(), 52);
+    for (const auto& pipeline : test.pipelines)
+    {
+      QCOMPARE(static_cast<unsigned int>(pipeline->GetRenderer()->GetLayer()), (pipeline->renderOrder + 10) / 20 + 1);
+    }
+  }
+
+  void testAddingToExistingLayerDoesntNotifyOtherPipelines() const
+  {
+    Test test(50);
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipeline->nRendererChanges = 0;
+    }
+
+    vtkNew<OrderedPipeline> pipeline;
+    pipeline->renderOrder = 250;
+    test.layerManager->AddPipeline(pipeline);
+    test.layerManager->RemovePipeline(pipeline);
+    QCOMPARE(pipeline->nRendererChanges, 2);
+
+    for (const auto& other : test.pipelines)
+    {
+      QCOMPARE(other->nRendererChanges, 0);
+    }
+  }
+
+  void testAddingToLowerMergedLayerKeepsPropsOrdered() const
+  {
+    Test test(10);
+    test.layerManager->SetMaximumNumberOfRenderers(1);
+    QCOMPARE(test.layerManager->GetNumberOfRenderers(), 1);
+    QCOMPARE(test.layerManager->GetNumberOfMergedLayers(), 9);
+
+    // Adding to the last layer of a merged renderer is incremental
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipeline->nRendererChanges = 0;
+    }
+    vtkNew<OrderedPipeline> topPipeline;
+    topPipeline->renderOrder = 100;
+    test.layerManager->AddPipeline(topPipeline);
+    QCOMPARE(topPipeline->nRendererChanges, 1);
+    for (const auto& pipeline : test.pipelines)
+    {
+      QCOMPARE(pipeline->nRendererChanges, 0);
+    }
+
+    // Adding to a lower layer reattaches the pipelines of the merged renderer in layer order
+    vtkNew<OrderedPipeline> lowPipeline;
+    lowPipeline->renderOrder = 10;
+    test.layerManager->AddPipeline(lowPipeline);
+    // Each pipeline is notified once when detached and once when reattached
+    QCOMPARE(lowPipeline->GetRenderer(), topPipeline->GetRenderer());
+    for (const auto& pipeline : test.pipelines)
+    {
+      QCOMPARE(pipeline->nRendererChanges, 2);
+    }
+
+    // The props of the shared renderer are drawn in render order
+    std::vector<OrderedPipeline*> pipelines{ topPipeline, lowPipeline };
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipelines.push_back(pipeline);
+    }
+    const auto renderOrders = GetPropRenderOrders(lowPipeline->GetRenderer(), pipelines);
+    QCOMPARE(static_cast<int>(renderOrders.size()), static_cast<int>(pipelines.size()));
+    QVERIFY(std::is_sorted(renderOrders.begin(), renderOrders.end()));
+    QCOMPARE(renderOrders.front(), 10u);
+    QCOMPARE(renderOrders.back(), 100u);
+  }
+
+  void testMovingPipelineBetweenExistingLayersOnlyNotifiesMovedPipeline() const
+  {
+    Test test(50, 2);
+    for (const auto& pipeline : test.pipelines)
+    {
+      pipeline->nRendererChanges = 0;
+    }
+
+    auto moved = test.pipelines.front();
+    const unsigned int previousOrder = moved->renderOrder;
+    moved->renderOrder = previousOrder == 500 ? 10 : 500;
+    test.layerManager->UpdatePipelineLayer(moved);
+    QCOMPARE(moved->nRendererChanges, 1);
+    QCOMPARE(static_cast<unsigned int>(moved->GetRenderer()->GetLayer()), moved->renderOrder / 10);
+
+    for (const auto& other : test.pipelines)
+    {
+      if (other != moved)
+      {
+        QCOMPARE(other->nRendererChanges, 0);
+      }
+    }
+  }
+
+  void benchmarkMovePipelineBetweenExistingLayers() const
+  {
+    Test test(BenchmarkDistinctOrders, 2);
+    auto pipeline = test.pipelines.front();
+    QBENCHMARK
+    {
+      pipeline->renderOrder = pipeline->renderOrder == 10 ? 20 : 10;
+      test.layerManager->UpdatePipelineLayer(pipeline);
+    }
+  }
+
+  void benchmarkAddToExistingLayer() const
+  {
+    Test test(BenchmarkDistinctOrders);
+    vtkNew<OrderedPipeline> pipeline;
+    pipeline->renderOrder = 10 * (BenchmarkDistinctOrders / 2);
+    QBENCHMARK
+    {
+      test.layerManager->AddPipeline(pipeline);
+      test.layerManager->RemovePipeline(pipeline);
+    }
+  }
+
+  void benchmarkCreateAndDeleteLayer() const
+  {
+    Test test(BenchmarkDistinctOrders);
+    vtkNew<OrderedPipeline> pipeline;
+    pipeline->renderOrder = 5;
+    QBENCHMARK
+    {
+      test.layerManager->AddPipeline(pipeline);
+      test.layerManager->RemovePipeline(pipeline);
+    }
+  }
+};
+
+CTK_TEST_MAIN(LayerManagerTest)
+
+#include "LayerManagerTest.moc"
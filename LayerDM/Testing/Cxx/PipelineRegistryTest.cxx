@@ -0,0 +1,233 @@
+// LayerDM includes
+#include "vtkMRMLLayerDMPipelineI.h"
+#include "vtkMRMLLayerDMPipelineRegistry.h"
+
+// Slicer includes
+#include <vtkMRMLScriptedModuleNode.h>
+
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STL includes
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include <ctkTest.h>
+
+namespace
+{
+struct Test
+{
+  explicit Test(int nPipelines)
+  {
+    for (int iPipeline = 0; iPipeline < nPipelines; iPipeline++)
+    {
+      nodes.emplace_back(vtkSmartPointer<vtkMRMLScriptedModuleNode>::New());
+      pipelines.emplace_back(vtkSmartPointer<vtkMRMLLayerDMPipelineI>::New());
+      registry.Insert(nodes.back(), pipelines.back());
+      map[nodes.back().GetPointer()] = pipelines.back();
+    }
+  }
+
+  std::vector<vtkSmartPointer<vtkMRMLNode>> nodes;
+  std::vector<vtkSmartPointer<vtkMRMLLayerDMPipelineI>> pipelines;
+  layer_dm::PipelineRegistry registry;
+
+  // Previous pipeline manager storage used as benchmark baseline
+  std::map<vtkWeakPointer<vtkMRMLNode>, vtkSmartPointer<vtkMRMLLayerDMPipelineI>> map;
+};
+
+constexpr int BenchmarkSize = 10000;
+} // namespace
+
+class PipelineRegistryTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testInsertedPipelinesCanBeFound() const
+  {
+    Test test(100);
+    QCOMPARE(static_cast<int>(test.registry.Size()), 100);
+    for (size_t iNode = 0; iNode < test.nodes.size(); iNode++)
+    {
+      QCOMPARE(test.registry.Find(test.nodes[iNode]), test.pipelines[iNode].GetPointer());
+    }
+
+    vtkNew<vtkMRMLScriptedModuleNode> notInserted;
+    QVERIFY(!test.registry.Find(notInserted));
+    QVERIFY(!test.registry.Find(nullptr));
+  }
+
+  void testInsertingExistingNodeReplacesPipeline() const
+  {
+    Test test(10);
+    auto pipeline = vtkSmartPointer<vtkMRMLLayerDMPipelineI>::New();
+    QVERIFY(!test.registry.Insert(test.nodes[3], pipeline));
+    QCOMPARE(static_cast<int>(test.registry.Size()), 10);
+    QCOMPARE(test.registry.Find(test.nodes[3]), pipeline.GetPointer());
+  }
+
+  void testErasedPipelinesAreSwapRemoved() const
+  {
+    Test test(1000);
+
+    // Remove every other node
+    for (size_t iNode = 0; iNode < test.nodes.size(); iNode += 2)
+    {
+      QVERIFY(test.registry.Erase(test.nodes[iNode]));
+      QVERIFY(!test.registry.Erase(test.nodes[iNode]));
+    }
+    QCOMPARE(static_cast<int>(test.registry.Size()), 500);
+
+    // Remaining nodes are still indexed and Nth access is consistent with the index
+    for (size_t iNode = 0; iNode < test.nodes.size(); iNode++)
+    {
+      const auto expected = iNode % 2 ? test.pipelines[iNode].GetPointer() : nullptr;
+      QCOMPARE(test.registry.Find(test.nodes[iNode]), expected);
+    }
+
+    for (size_t iEntry = 0; iEntry < test.registry.Size(); iEntry++)
+    {
+      const auto& entry = test.registry[iEntry];
+      QCOMPARE(test.registry.Find(entry.Key), entry.Pipeline.GetPointer());
+    }
+  }
+
+  void testDeletedNodesCanBeRemovedUsingTheirKey() const
+  {
+    layer_dm::PipelineRegistry registry;
+    auto node = vtkSmartPointer<vtkMRMLScriptedModuleNode>::New();
+    registry.Insert(node, vtkSmartPointer<vtkMRMLLayerDMPipelineI>::New());
+
+    auto key = registry[0].Key;
+    node = nullptr;
+    QVERIFY(!registry[0].Node);
+    QVERIFY(registry.Erase(key));
+    QVERIFY(registry.Empty());
+  }
+
+  void testNodesAllocatedAtDeletedNodeAddressAreNotFound() const
+  {
+    layer_dm::PipelineRegistry registry;
+    auto node = vtkSmartPointer<vtkMRMLScriptedModuleNode>::New();
+    auto stalePipeline = vtkSmartPointer<vtkMRMLLayerDMPipelineI>::New();
+    registry.Insert(node, stalePipeline);
+    const auto key = registry[0].Key;
+    node = nullptr;
+
+    // Allocate nodes until the allocator reuses the deleted node address
+    std::vector<vtkSmartPointer<vtkMRMLScriptedModuleNode>> newNodes;
+    for (int iNode = 0; iNode < 100 && (newNodes.empty() || newNodes.back().GetPointer() != key); iNode++)
+    {
+      newNodes.emplace_back(vtkSmartPointer<vtkMRMLScriptedModuleNode>::New());
+    }
+    if (newNodes.back().GetPointer() != key)
+    {
+      QSKIP("Deleted node address was not reused by the allocator");
+    }
+
+    // The stale entry is only reachable by key and is replaced on insert
+    const auto& reusedNode = newNodes.back();
+    QVERIFY(!registry.Find(reusedNode));
+    QVERIFY(!registry.Contains(reusedNode));
+    QCOMPARE(registry.FindByKey(key), stalePipeline.GetPointer());
+
+    auto pipeline = vtkSmartPointer<vtkMRMLLayerDMPipelineI>::New();
+    QVERIFY(registry.Insert(reusedNode, pipeline));
+    QCOMPARE(static_cast<int>(registry.Size()), 1);
+    QCOMPARE(registry.Find(reusedNode), pipeline.GetPointer());
+    QVERIFY(registry.Contains(reusedNode));
+  }
+
+  void testAddressesAtPowerOfTwoStrideHaveBoundedProbeLength() const
+  {
+    // Nodes of the same class are usually allocated at power of two strides
+    constexpr std::uintptr_t base = 0x10000000;
+    constexpr std::uintptr_t stride = 1024;
+    layer_dm::AddressIndex index;
+    for (std::size_t iKey = 0; iKey < 4096; iKey++)
+    {
+      index.Insert(reinterpret_cast<const void*>(base + iKey * stride), iKey);
+    }
+
+    QCOMPARE(static_cast<int>(index.Size()), 4096);
+    QVERIFY(index.GetMaxProbeLength() <= 8);
+    for (std::size_t iKey = 0; iKey < 4096; iKey++)
+    {
+      QCOMPARE(index.Find(reinterpret_cast<const void*>(base + iKey * stride)), iKey);
+    }
+
+    for (std::size_t iKey = 0; iKey < 4096; iKey += 2)
+    {
+      QVERIFY(index.Erase(reinterpret_cast<const void*>(base + iKey * stride)));
+    }
+    QCOMPARE(static_cast<int>(index.Size()), 2048);
+    QVERIFY(index.GetMaxProbeLength() <= 8);
+    QCOMPARE(index.Find(reinterpret_cast<const void*>(base)), layer_dm::AddressIndex::NotFound);
+    QCOMPARE(index.Find(reinterpret_cast<const void*>(base + stride)), std::size_t{ 1 });
+  }
+
+  void benchmarkNthAccessMap() const
+  {
+    Test test(BenchmarkSize);
+    int nValid = 0;
+    QBENCHMARK
+    {
+      for (int iPipeline = 0; iPipeline < BenchmarkSize; iPipeline += 100)
+      {
+        nValid += std::next(test.map.begin(), iPipeline)->second != nullptr;
+      }
+    }
+    QVERIFY(nValid > 0);
+  }
+
+  void benchmarkNthAccessRegistry() const
+  {
+    Test test(BenchmarkSize);
+    int nValid = 0;
+    QBENCHMARK
+    {
+      for (int iPipeline = 0; iPipeline < BenchmarkSize; iPipeline += 100)
+      {
+        nValid += test.registry[iPipeline].Pipeline != nullptr;
+      }
+    }
+    QVERIFY(nValid > 0);
+  }
+
+  void benchmarkSweepAndFindMap() const
+  {
+    Test test(BenchmarkSize);
+    int nFound = 0;
+    QBENCHMARK
+    {
+      for (const auto& pair : test.map)
+      {
+        nFound += test.map.find(pair.first) != test.map.end();
+      }
+    }
+    QVERIFY(nFound > 0);
+  }
+
+  void benchmarkSweepAndFindRegistry() const
+  {
+    Test test(BenchmarkSize);
+    int nFound = 0;
+    QBENCHMARK
+    {
+      for (const auto& entry : test.registry)
+      {
+        nFound += test.registry.Contains(entry.Key);
+      }
+    }
+    QVERIFY(nFound > 0);
+  }
+};
+
+CTK_TEST_MAIN(PipelineRegistryTest)
+
+#include "PipelineRegistryTest.moc"
@@ -0,0 +1,150 @@
+// LayerDM includes
+#include "vtkMRMLLayerDMTracer.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// STL includes
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ctkTest.h>
+
+namespace
+{
+void RecordEvents(vtkMRMLLayerDMTracer* tracer, int nEvents)
+{
+  vtkMRMLLayerDMTracer::Event event;
+  event.Name = "Event";
+  event.Category = "test";
+  for (int iEvent = 0; iEvent < nEvents; iEvent++)
+  {
+    event.Start = tracer->GetTimestamp();
+    tracer->Record(event);
+  }
+}
+} // namespace
+
+class TracerTester : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testFullBuffersDropNewEvents() const
+  {
+    vtkNew<vtkMRMLLayerDMTracer> tracer;
+    tracer->SetBufferCapacity(4);
+    RecordEvents(tracer, 10);
+    QCOMPARE(tracer->GetNumberOfEvents(), 4);
+    QCOMPARE(tracer->GetNumberOfDroppedEvents(), 6);
+
+    tracer->Clear();
+    QCOMPARE(tracer->GetNumberOfEvents(), 0);
+    QCOMPARE(tracer->GetNumberOfDroppedEvents(), 0);
+  }
+
+  void testRingBufferKeepsLatestEvents() const
+  {
+    vtkNew<vtkMRMLLayerDMTracer> tracer;
+    tracer->SetBufferCapacity(4);
+    tracer->SetRingBufferMode(true);
+    RecordEvents(tracer, 10);
+    QCOMPARE(tracer->GetNumberOfEvents(), 4);
+    QCOMPARE(tracer->GetNumberOfDroppedEvents(), 0);
+  }
+
+  void testRingBufferExportDuringRecordingHasNoTornEvents() const
+  {
+    vtkNew<vtkMRMLLayerDMTracer> tracer;
+    tracer->SetBufferCapacity(16);
+    tracer->SetRingBufferMode(true);
+
+    // Each event start and duration are written with the same value, a torn copy would mix two events
+    std::atomic<bool> isRecording{ true };
+    std::thread writer(
+      [&tracer, &isRecording]
+      {
+        vtkMRMLLayerDMTracer::Event event;
+        event.Name = "Event";
+        event.Category = "test";
+        for (int iEvent = 0; isRecording; iEvent++)
+        {
+          event.Start = iEvent;
+          event.Duration = iEvent;
+          tracer->Record(event);
+        }
+      });
+
+    int nExportedEvents = 0;
+    for (int iExport = 0; iExport < 200; iExport++)
+    {
+      const auto trace = tracer->GetChromeTrace();
+      for (auto pos = trace.find("\"ts\":"); pos != std::string::npos; pos = trace.find("\"ts\":", pos + 1))
+      {
+        double start = -1;
+        double duration = -2;
+        QCOMPARE(std::sscanf(trace.c_str() + pos, "\"ts\":%lf,\"dur\":%lf", &start, &duration), 2);
+        QCOMPARE(start, duration);
+        nExportedEvents++;
+      }
+    }
+    isRecording = false;
+    writer.join();
+    QVERIFY(nExportedEvents > 0);
+  }
+
+  void testEventsAreRecordedPerThread() const
+  {
+    vtkNew<vtkMRMLLayerDMTracer> tracer;
+    std::vector<std::thread> threads;
+    for (int iThread = 0; iThread < 4; iThread++)
+    {
+      threads.emplace_back([&tracer] { RecordEvents(tracer, 100); });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    QCOMPARE(tracer->GetNumberOfEvents(), 400);
+
+    const auto trace = tracer->GetChromeTrace();
+    QVERIFY(trace.find(R"("traceEvents")") != std::string::npos);
+    QVERIFY(trace.find(R"("tid":4)") != std::string::npos);
+  }
+
+  void testEventArgumentsAreEscaped() const
+  {
+    vtkNew<vtkMRMLLayerDMTracer> tracer;
+    vtkMRMLLayerDMTracer::Event event;
+    event.Name = "Quoted \"name\"";
+    tracer->Record(event);
+    QVERIFY(tracer->GetChromeTrace().find(R"("name":"Quoted \"name\"")") != std::string::npos);
+  }
+
+  void testScopeIsNoOpWhenSingletonIsDisabled() const
+  {
+    auto tracer = vtkMRMLLayerDMTracer::GetInstance();
+    tracer->SetEnabled(false);
+    tracer->Clear();
+    {
+      vtkMRMLLayerDMTracer::Scope scope{ "Disabled", "test" };
+    }
+    QCOMPARE(tracer->GetNumberOfEvents(), 0);
+
+    tracer->SetEnabled(true);
+    {
+      vtkMRMLLayerDMTracer::Scope scope{ "Enabled", "test" };
+    }
+    tracer->SetEnabled(false);
+    QCOMPARE(tracer->GetNumberOfEvents(), 1);
+    QVERIFY(tracer->GetChromeTrace().find(R"("name":"Enabled")") != std::string::npos);
+    tracer->Clear();
+  }
+};
+
+CTK_TEST_MAIN(TracerTest)
+
+#include "TracerTest.moc"
@@ -135,3 +135,19 @@ class InteractionLogicTest(ScriptedLoadableModuleTest):
         assert self.logic.ProcessInteractionEvent(self.event)
 
         p1.mockProcess.assert_called_once()
+
+    def test_scripted_pipelines_are_polled_on_the_main_thread(self):
+        pipelines = []
+        for i in range(5):
+            pipeline = MockPipeline(canProcess=True, didProcess=True, processDistance=i)
+            pipeline.SetReentrantCanProcessInteractionEvent(True)
+            pipelines.append(pipeline)
+            self.logic.AddPipeline(pipeline)
+
+        self.logic.SetConcurrentPollingThreshold(1)
+        assert not pipelines[0].IsReentrantCanProcessInteractionEvent()
+        assert self.logic.CanProcessInteractionEvent(self.event, self.distance)
+        assert self.logic.GetNumberOfPolledPipelines() == 5
+        assert self.logic.GetNumberOfConcurrentlyPolledPipelines() == 0
+        assert self.logic.ProcessInteractionEvent(self.event)
+        pipelines[0].mockProcess.assert_called_once_with(self.event)
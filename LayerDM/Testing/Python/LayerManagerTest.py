@@ -2,7 +2,18 @@ import slicer
 from LayerDMLib import vtkMRMLLayerDMScriptedPipeline
 from slicer import vtkMRMLLayerDMLayerManager
 from slicer.ScriptedLoadableModule import ScriptedLoadableModuleTest
-from vtk import vtkActor, vtkCamera, vtkPolyDataMapper, vtkRenderWindow, vtkRenderer, vtkSphereSource
+from vtk import (
+    vtkActor,
+    vtkCamera,
+    vtkHardwareSelector,
+    vtkPolyDataMapper,
+    vtkRenderStepsPass,
+    vtkRenderWindow,
+    vtkRenderer,
+    vtkSelectionNode,
+    vtkSphereSource,
+)
+from MockPipeline import MockPipeline
 
 
 class Pipeline(vtkMRMLLayerDMScriptedPipeline):
@@ -265,3 +276,256 @@ class LayerManagerTest(ScriptedLoadableModuleTest):
 
         assert custom_camera.GetClippingRange()[0] != prev_clipping_range[0]
         assert custom_camera.GetClippingRange()[1] != prev_clipping_range[1]
+
+    @staticmethod
+    def reset_renderer_mocks(pipelines: list[MockPipeline]):
+        for pipeline in pipelines:
+            pipeline.mockOnRendererAdded.reset_mock()
+            pipeline.mockOnRendererRemoved.reset_mock()
+
+    @staticmethod
+    def assert_renderer_mocks_not_called(pipelines: list[MockPipeline]):
+        for pipeline in pipelines:
+            pipeline.mockOnRendererAdded.assert_not_called()
+            pipeline.mockOnRendererRemoved.assert_not_called()
+
+    def test_adding_and_removing_pipelines_in_existing_layers_doesnt_notify_other_pipelines(self):
+        pipelines = [MockPipeline(renderOrder=order) for order in [0, 0, 1, 1, 2]]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+        self.reset_renderer_mocks(pipelines)
+
+        added = [MockPipeline(renderOrder=order) for order in [0, 1, 2]]
+        for pipeline in added:
+            self.layerManager.AddPipeline(pipeline)
+        self.assert_renderer_mocks_not_called(pipelines)
+
+        for pipeline, expRenderer in zip(added, [pipelines[0], pipelines[2], pipelines[4]]):
+            pipeline.mockOnRendererAdded.assert_called_once_with(expRenderer.GetRenderer())
+
+        for pipeline in added:
+            self.layerManager.RemovePipeline(pipeline)
+            pipeline.mockOnRendererRemoved.assert_called_once()
+            assert pipeline.GetRenderer() is None
+        self.assert_renderer_mocks_not_called(pipelines)
+        assert self.layerManager.GetNumberOfRenderers() == 2
+
+    def test_creating_and_deleting_layers_doesnt_notify_pipelines_of_lower_layers(self):
+        pipelines = [MockPipeline(renderOrder=order) for order in [0, 1]]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+        self.reset_renderer_mocks(pipelines)
+
+        newLayerPipeline = MockPipeline(renderOrder=2)
+        self.layerManager.AddPipeline(newLayerPipeline)
+        self.layerManager.RemovePipeline(newLayerPipeline)
+        self.assert_renderer_mocks_not_called(pipelines)
+        assert self.layerManager.GetNumberOfRenderers() == 1
+
+    def test_renderer_bounds_are_only_recomputed_when_their_props_are_modified(self):
+        pipelines = self.configure_layer_manager_with_multiple_pipelines()
+        self.layerManager.ResetCameraClippingRange()
+        nComputations = self.layerManager.GetNumberOfBoundsComputations()
+        assert nComputations > 0
+
+        self.layerManager.ResetCameraClippingRange()
+        assert self.layerManager.GetNumberOfBoundsComputations() == nComputations
+
+        # Moving an actor only recomputes the bounds of its renderer and updates its camera group clipping range
+        prevClippingRange = self.defaultCamera.GetClippingRange()
+        pipelines[1]._actor.SetPosition(0, 0, -500)
+        self.layerManager.ResetCameraClippingRange()
+        assert self.layerManager.GetNumberOfBoundsComputations() == nComputations + 1
+        assert self.defaultCamera.GetClippingRange() != prevClippingRange
+
+        # Modifying a mapper input only recomputes the bounds of its renderer
+        pipelines[2]._sphere.SetRadius(20)
+        pipelines[2]._sphere.Update()
+        self.layerManager.ResetCameraClippingRange()
+        assert self.layerManager.GetNumberOfBoundsComputations() == nComputations + 2
+
+    def test_slab_clipping_range_mode_skips_default_camera_bounds(self):
+        pipelines = self.configure_layer_manager_with_multiple_pipelines()
+        self.defaultCamera.SetPosition(0, 0, 10)
+        self.defaultCamera.SetFocalPoint(0, 0, 0)
+
+        self.layerManager.SetClippingRangeMode(vtkMRMLLayerDMLayerManager.SlabClippingRange)
+        self.layerManager.SetSlabThickness(2)
+        self.layerManager.ResetCameraClippingRange()
+
+        # Only the default renderer and the custom camera renderer bounds are computed
+        assert self.layerManager.GetNumberOfBoundsComputations() == 2
+        assert self.defaultCamera.GetClippingRange() == (9, 11)
+
+        # Off-slice actors don't affect the slab clipping
+        pipelines[1]._actor.SetPosition(0, 0, -5000)
+        self.layerManager.ResetCameraClippingRange()
+        assert self.defaultCamera.GetClippingRange() == (9, 11)
+
+    def test_deleted_layer_renderers_are_parked_and_reused(self):
+        self.layerManager.SetRendererPoolSize(1)
+        pipelines = [Pipeline(order) for order in [1, 2]]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+        renderers = [pipeline.GetRenderer() for pipeline in pipelines]
+
+        for pipeline in pipelines:
+            self.layerManager.RemovePipeline(pipeline)
+        assert self.layerManager.GetNumberOfRenderers() == 0
+        assert self.layerManager.GetNumberOfPooledRenderers() == 1
+        assert self.renderWindow.GetRenderers().GetNumberOfItems() == 1
+
+        # Renderers of the deleted layers are detached from the render window
+        detached = [renderer for renderer in renderers if not self.renderWindow.HasRenderer(renderer)]
+        assert len(detached) == 2
+        self.layerManager.ResetRendererPoolStatistics()
+
+        newPipelines = [Pipeline(order) for order in [3, 4]]
+        for pipeline in newPipelines:
+            self.layerManager.AddPipeline(pipeline)
+        assert self.layerManager.GetNumberOfRendererPoolHits() == 1
+        assert self.layerManager.GetNumberOfRendererPoolMisses() == 1
+        assert self.layerManager.GetNumberOfPooledRenderers() == 0
+        assert newPipelines[0].GetRenderer() in renderers
+        assert newPipelines[0].GetRenderer().GetDraw()
+        self.assert_are_expected_layers([[pipeline] for pipeline in newPipelines], expRenderLayers=[1, 2])
+
+    def test_layers_over_renderer_budget_are_merged_in_render_order(self):
+        self.layerManager.SetMaximumNumberOfRenderers(2)
+        pipelines = [Pipeline(order) for order in [1, 2, 3, 4]]
+        for pipeline in reversed(pipelines):
+            self.layerManager.AddPipeline(pipeline)
+
+        assert self.layerManager.GetNumberOfRenderers() == 2
+        assert self.layerManager.GetNumberOfDistinctLayers() == 5
+        assert self.layerManager.GetNumberOfMergedLayers() == 2
+        assert [self.layerManager.GetLayerRenderOrder(i) for i in range(5)] == [0, 1, 2, 3, 4]
+        assert [self.layerManager.GetLayerRendererLayer(i) for i in range(5)] == [0, 1, 1, 1, 2]
+        assert self.layerManager.GetLayerRenderer(2) == pipelines[0].GetRenderer()
+
+        # Props of the merged layers are ordered by render order
+        props = pipelines[0].GetRenderer().GetViewProps()
+        assert [props.GetItemAsObject(i) for i in range(props.GetNumberOfItems())] == [p._actor for p in pipelines[:3]]
+
+        # Removing the budget restores one renderer per layer
+        self.layerManager.SetMaximumNumberOfRenderers(0)
+        assert self.layerManager.GetNumberOfMergedLayers() == 0
+        self.assert_are_expected_layers([[pipeline] for pipeline in pipelines], expRenderLayers=[1, 2, 3, 4])
+
+    def test_layers_with_different_cameras_or_custom_passes_are_not_merged(self):
+        self.layerManager.SetMaximumNumberOfRenderers(1)
+        customPass = Pipeline(2)
+        customPass.SetUsesCustomRenderPass(True)
+        pipelines = [Pipeline(1), customPass, Pipeline(3), Pipeline(4, vtkCamera())]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+
+        assert self.layerManager.GetNumberOfMergedLayers() == 0
+        assert self.layerManager.GetNumberOfRenderers() == 4
+        assert self.layerManager.GetLayerCamera(4) == pipelines[-1].GetCustomCamera()
+        assert self.layerManager.GetLayerCamera(1) == self.defaultCamera
+
+    def test_renderers_without_visible_props_are_not_drawn(self):
+        pipelines = [Pipeline(order) for order in [1, 2]]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+
+        pipelines[0]._actor.SetVisibility(False)
+        self.layerManager.UpdateRendererDrawStates()
+        assert self.layerManager.GetNumberOfSkippedLayerDraws() == 1
+        assert not pipelines[0].GetRenderer().GetDraw()
+        assert pipelines[1].GetRenderer().GetDraw()
+
+        # Renderers with a render pass are always drawn
+        pipelines[0].GetRenderer().SetPass(vtkRenderStepsPass())
+        self.layerManager.UpdateRendererDrawStates()
+        assert self.layerManager.GetNumberOfSkippedLayerDraws() == 0
+        assert pipelines[0].GetRenderer().GetDraw()
+
+        pipelines[0].GetRenderer().SetPass(None)
+        self.layerManager.SetSkipEmptyLayersDraw(False)
+        assert self.layerManager.GetNumberOfSkippedLayerDraws() == 0
+        assert pipelines[0].GetRenderer().GetDraw()
+
+    def test_pipelines_are_moved_to_their_new_layer_when_their_render_order_changes(self):
+        pipelines = [Pipeline(order) for order in [1, 1, 2, 3]]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+        renderers = [pipeline.GetRenderer() for pipeline in pipelines]
+
+        # Moving between existing layers keeps the other renderers unchanged
+        pipelines[0]._renderOrder = 3
+        self.layerManager.UpdatePipelineLayer(pipelines[0])
+        assert pipelines[0].GetRenderer() == renderers[3]
+        assert [pipeline.GetRenderer() for pipeline in pipelines[1:]] == renderers[1:]
+
+        # Moving to a new layer creates it
+        pipelines[0]._renderOrder = 4
+        self.layerManager.UpdatePipelineLayer(pipelines[0])
+        self.assert_are_expected_layers([[pipelines[1]], [pipelines[2]], [pipelines[3]], [pipelines[0]]], expRenderLayers=[1, 2, 3, 4])
+
+        # Removal uses the layer the pipeline was moved to, even if its render order changed again without notification
+        pipelines[0]._renderOrder = 2
+        self.layerManager.RemovePipeline(pipelines[0])
+        assert pipelines[0].GetRenderer() is None
+        self.assert_are_expected_layers([[pipelines[1]], [pipelines[2]], [pipelines[3]]], expRenderLayers=[1, 2, 3])
+
+    def test_cached_layers_are_only_rendered_again_when_modified(self):
+        self.renderWindow.SetOffScreenRendering(True)
+        self.renderWindow.SetSize(64, 64)
+        self.layerManager.SetRenderOrderCached(1, True)
+        pipelines = [Pipeline(1), Pipeline(2)]
+        for pipeline in pipelines:
+            self.layerManager.AddPipeline(pipeline)
+
+        cachePass = self.layerManager.GetLayerCachePass(1)
+        assert cachePass is not None
+        assert self.layerManager.GetLayerCachePass(2) is None
+
+        for _ in range(2):
+            self.renderWindow.Render()
+        cachePass.ResetCacheStatistics()
+        self.renderWindow.Render()
+        assert cachePass.GetNumberOfCacheHits() == 1
+        assert cachePass.GetNumberOfCacheMisses() == 0
+
+        # Modifying the props or the camera renders the layer again
+        pipelines[0]._sphere.SetRadius(5)
+        pipelines[0]._sphere.Update()
+        self.renderWindow.Render()
+        assert cachePass.GetNumberOfCacheMisses() == 1
+
+        self.defaultCamera.Azimuth(10)
+        self.renderWindow.Render()
+        assert cachePass.GetNumberOfCacheMisses() == 2
+
+        self.layerManager.SetRenderOrderCached(1, False)
+        assert self.layerManager.GetLayerCachePass(1) is None
+
+    def test_cached_layers_are_not_used_during_hardware_selection(self):
+        self.renderWindow.SetOffScreenRendering(True)
+        self.renderWindow.SetSize(64, 64)
+        self.layerManager.SetRenderOrderCached(1, True)
+        pipeline = Pipeline(1)
+        self.layerManager.AddPipeline(pipeline)
+
+        cachePass = self.layerManager.GetLayerCachePass(1)
+        for _ in range(2):
+            self.renderWindow.Render()
+        cachePass.ResetCacheStatistics()
+
+        # Selection renders the props of the cached layer directly, without hit nor miss
+        selector = vtkHardwareSelector()
+        selector.SetRenderer(pipeline.GetRenderer())
+        selector.SetArea(0, 0, 63, 63)
+        selection = selector.Select()
+        pickedProps = [
+            selection.GetNode(iNode).GetProperties().Get(vtkSelectionNode.PROP()) for iNode in range(selection.GetNumberOfNodes())
+        ]
+        assert pipeline._actor in pickedProps
+        assert cachePass.GetNumberOfCacheHits() == 0
+        assert cachePass.GetNumberOfCacheMisses() == 0
+
+        # The cache is still valid once the selection is done
+        self.renderWindow.Render()
+        assert cachePass.GetNumberOfCacheHits() == 1
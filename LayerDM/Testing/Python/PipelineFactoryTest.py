@@ -7,7 +7,8 @@ from slicer import (
     vtkMRMLLayerDMPipelineScriptedCreator,
     vtkMRMLLayerDMPipelineCreatorI,
     vtkMRMLViewNode,
-    vtkMRMLCameraNode
+    vtkMRMLCameraNode,
+    vtkMRMLModelNode,
 )
 from slicer.ScriptedLoadableModule import ScriptedLoadableModuleTest
 from vtk import vtkCommand
@@ -130,3 +131,90 @@ class PipelineFactoryTest(ScriptedLoadableModuleTest):
         # Lower priority implies lower priority in creation
         c2.SetPriority(-1)
         assert self.factory.CreatePipeline(viewNode, node) == i1
+
+    def test_class_based_creators_are_not_called_for_rejected_classes(self):
+        classBasedMock = MagicMock(return_value=None)
+        classBased = vtkMRMLLayerDMPipelineScriptedCreator()
+        classBased.SetPythonCallback(classBasedMock)
+        classBased.ClassBasedDecisionOn()
+
+        otherMock = MagicMock(return_value=None)
+        other = vtkMRMLLayerDMPipelineScriptedCreator()
+        other.SetPythonCallback(otherMock)
+
+        self.factory.AddPipelineCreator(classBased)
+        self.factory.AddPipelineCreator(other)
+
+        viewNode = vtkMRMLViewNode()
+        for _ in range(5):
+            assert self.factory.CreatePipeline(viewNode, vtkMRMLCameraNode()) is None
+
+        classBasedMock.assert_called_once()
+        assert otherMock.call_count == 5
+        assert self.factory.GetNegativeCacheSize() == 1
+
+    def test_negative_cache_is_cleared_on_creator_changes(self):
+        mock = MagicMock(return_value=None)
+        creator = vtkMRMLLayerDMPipelineScriptedCreator()
+        creator.SetPythonCallback(mock)
+        creator.ClassBasedDecisionOn()
+        self.factory.AddPipelineCreator(creator)
+
+        viewNode = vtkMRMLViewNode()
+        node = vtkMRMLCameraNode()
+        self.factory.CreatePipeline(viewNode, node)
+        assert self.factory.GetNegativeCacheSize() == 1
+
+        creator.SetPriority(42)
+        assert self.factory.GetNegativeCacheSize() == 0
+
+        self.factory.CreatePipeline(viewNode, node)
+        self.factory.AddPipelineCreator(vtkMRMLLayerDMPipelineCreatorI())
+        assert self.factory.GetNegativeCacheSize() == 0
+
+        instance = vtkMRMLLayerDMPipelineI()
+        mock.return_value = instance
+        assert self.factory.CreatePipeline(viewNode, node) == instance
+
+    def test_creators_with_declared_types_are_only_called_for_matching_classes(self):
+        modelMock = MagicMock(return_value=None)
+        modelCreator = vtkMRMLLayerDMPipelineScriptedCreator()
+        modelCreator.SetPythonCallback(modelMock)
+        modelCreator.AddAcceptedTypes("vtkMRMLViewNode", "vtkMRMLDisplayableNode")
+
+        undeclaredMock = MagicMock(return_value=None)
+        undeclaredCreator = vtkMRMLLayerDMPipelineScriptedCreator()
+        undeclaredCreator.SetPythonCallback(undeclaredMock)
+
+        self.factory.AddPipelineCreator(modelCreator)
+        self.factory.AddPipelineCreator(undeclaredCreator)
+
+        viewNode = vtkMRMLViewNode()
+        cameraNode = vtkMRMLCameraNode()
+        modelNode = vtkMRMLModelNode()
+
+        assert self.factory.GetNumberOfCandidateCreators(viewNode, cameraNode) == 1
+        assert self.factory.GetNumberOfCandidateCreators(viewNode, modelNode) == 2
+
+        self.factory.CreatePipeline(viewNode, cameraNode)
+        modelMock.assert_not_called()
+        undeclaredMock.assert_called_once_with(viewNode, cameraNode)
+
+        # Derived classes of the declared types are accepted
+        self.factory.CreatePipeline(viewNode, modelNode)
+        modelMock.assert_called_once_with(viewNode, modelNode)
+
+    def test_declaring_types_updates_the_candidate_creators(self):
+        creator = vtkMRMLLayerDMPipelineScriptedCreator()
+        creator.SetPythonCallback(MagicMock(return_value=None))
+        self.factory.AddPipelineCreator(creator)
+
+        viewNode = vtkMRMLViewNode()
+        cameraNode = vtkMRMLCameraNode()
+        assert self.factory.GetNumberOfCandidateCreators(viewNode, cameraNode) == 1
+
+        creator.AddAcceptedTypes("vtkMRMLSliceNode", "vtkMRMLCameraNode")
+        assert self.factory.GetNumberOfCandidateCreators(viewNode, cameraNode) == 0
+
+        creator.ClearAcceptedTypes()
+        assert self.factory.GetNumberOfCandidateCreators(viewNode, cameraNode) == 1
@@ -1,18 +1,24 @@
+import json
 from unittest.mock import MagicMock
 
 import slicer
 from slicer import (
     vtkMRMLLayerDMPipelineFactory,
+    vtkMRMLLayerDMPipelineI,
     vtkMRMLLayerDMPipelineManager,
     vtkMRMLLayerDMPipelineScriptedCreator,
+    vtkMRMLLayerDMTracer,
     vtkMRMLAbstractViewNode,
     vtkMRMLInteractionEventData,
     vtkMRMLMarkupsFiducialNode,
     vtkMRMLModelNode,
     vtkMRMLScalarVolumeNode,
+    vtkMRMLScene,
+    vtkMRMLScriptedModuleNode,
 )
 from slicer.ScriptedLoadableModule import ScriptedLoadableModuleTest
-from vtk import vtkRenderWindow, reference as ref, vtkCommand, vtkRenderer
+from vtk import VTK_OBJECT, vtkRenderWindow, reference as ref, vtkCommand, vtkRenderer
+from vtkmodules.util.misc import calldata_type
 from MockPipeline import MockPipeline
 
 
@@ -96,6 +102,65 @@ class PipelineManagerTest(ScriptedLoadableModuleTest):
         self.pipelineManager.UpdateFromScene()
         assert self.pipelineManager.GetNodePipeline(modelNode) is None
 
+    def test_on_scene_update_only_processes_scene_changes(self):
+        self.pipelineManager.UpdateFromScene()
+        modelNodes = [slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode") for _ in range(3)]
+        assert self.pipelineManager.GetNumberOfPendingSceneChanges() == 3
+
+        self.mockModelCreate.reset_mock()
+        self.pipelineManager.UpdateFromScene()
+        assert self.pipelineManager.GetNumberOfPendingSceneChanges() == 0
+        assert self.mockModelCreate.call_count == 3
+        for modelNode in modelNodes:
+            assert self.pipelineManager.GetNodePipeline(modelNode) is not None
+
+        self.mockModelCreate.reset_mock()
+        self.pipelineManager.UpdateFromScene()
+        self.mockModelCreate.assert_not_called()
+
+    def test_nodes_forwarded_by_the_displayable_manager_are_not_recorded_as_scene_changes(self):
+        # Displayable manager scene observer forwarding the added nodes before the pipeline manager one
+        @calldata_type(VTK_OBJECT)
+        def onNodeAdded(_caller, _event, node):
+            self.pipelineManager.AddNode(node)
+
+        self.pipelineManager.UpdateFromScene()
+        tag = slicer.mrmlScene.AddObserver(vtkMRMLScene.NodeAddedEvent, onNodeAdded, 1.0)
+        modelNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode")
+        rejectedNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScriptedModuleNode")
+        slicer.mrmlScene.RemoveObserver(tag)
+
+        assert self.pipelineManager.GetNodePipeline(modelNode) is not None
+        assert self.pipelineManager.GetNodePipeline(rejectedNode) is None
+        assert self.pipelineManager.GetNumberOfPendingSceneChanges() == 0
+
+    def test_nodes_added_back_after_their_removal_are_recorded_as_scene_changes(self):
+        # Node processed and removed outside of a scene NodeAdded dispatch
+        self.pipelineManager.UpdateFromScene()
+        rejectedNode = vtkMRMLScriptedModuleNode()
+        self.pipelineManager.AddNode(rejectedNode)
+        self.pipelineManager.RemoveNode(rejectedNode)
+
+        slicer.mrmlScene.AddNode(rejectedNode)
+        assert self.pipelineManager.GetNumberOfPendingSceneChanges() == 1
+
+    def test_on_creator_added_only_new_creator_is_probed_for_nodes_without_pipeline(self):
+        modelNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode")
+        volumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+        self.pipelineManager.UpdateFromScene()
+        assert self.pipelineManager.GetNodePipeline(modelNode) is not None
+
+        self.mockModelCreate.reset_mock()
+        volumeCreator = vtkMRMLLayerDMPipelineScriptedCreator()
+        volumeCreator.SetPythonCallback(self.createVolumePipeline)
+        self.factory.AddPipelineCreator(volumeCreator)
+
+        self.mockModelCreate.assert_not_called()
+        probedNodes = [call.args[1] for call in self.mockVolumeCreate.call_args_list]
+        assert volumeNode in probedNodes
+        assert modelNode not in probedNodes
+        assert self.pipelineManager.GetNodePipeline(volumeNode) is not None
+
     def triggerMockPipelineCreation(self, mock: MockPipeline) -> MockPipeline:
         self.nextMock = mock
         node = vtkMRMLMarkupsFiducialNode()
@@ -154,10 +219,33 @@ class PipelineManagerTest(ScriptedLoadableModuleTest):
         assert self.pipelineManager.ProcessInteractionEvent(vtkMRMLInteractionEventData())
 
         # Expect m1 to have handled the interaction regardless of m2 proximity
+        # The active focused pipeline is polled alone, m2 is only polled for the first interaction
         assert m1.mockProcess.call_count == 2
         m2.mockProcess.assert_not_called()
         assert m1.mockCanProcess.call_count == 2
-        assert m2.mockCanProcess.call_count == 2
+        assert m2.mockCanProcess.call_count == 1
+
+    def test_active_focused_pipeline_keeps_exclusive_focus_until_it_cannot_process(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(renderOrder=1, canProcess=True, processDistance=0, didProcess=True))
+        m2 = self.triggerMockPipelineCreation(MockPipeline(renderOrder=10, canProcess=False, didProcess=True))
+        assert self.dispatchEvent(self.createEvent(vtkCommand.LeftButtonPressEvent))
+
+        # While dragging, m1 is the only polled pipeline even if m2 could process the moves
+        m1.mockGetWidgetState.return_value = 2
+        m2.mockCanProcess.return_value = (True, 0)
+        m2.mockCanProcess.reset_mock()
+        for x in range(3):
+            assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, x))
+        m2.mockCanProcess.assert_not_called()
+        assert self.pipelineManager.GetNumberOfPolledPipelines() == 1
+
+        # When m1 cannot process anymore, all the pipelines are polled and m1 is only asked once
+        m1.mockCanProcess.reset_mock()
+        m1.mockCanProcess.return_value = (False, 0)
+        assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent))
+        m1.mockCanProcess.assert_called_once()
+        m2.mockCanProcess.assert_called_once()
+        m1.mockLoseFocus.assert_called_once()
 
     def test_on_lose_focus_forwards_information_of_last_with_focus(self):
         m1 = self.triggerMockPipelineCreation(MockPipeline(renderOrder=1))
@@ -224,6 +312,157 @@ class PipelineManagerTest(ScriptedLoadableModuleTest):
         m2.mockProcess.assert_called_once()
         m1.mockLoseFocus.assert_called_once()
 
+    def test_only_pipelines_with_bounds_containing_the_event_position_are_polled(self):
+        # World bounds are tested against the event world position in slice views
+        self.pipelineManager.SetViewNode(slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSliceNode"))
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0))
+        m2 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0))
+        m3 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0))
+        m1.SetWorldInteractionBounds([0, 10, 0, 10, 0, 10])
+        m2.SetWorldInteractionBounds([20, 30, 0, 10, 0, 10])
+
+        eventData = vtkMRMLInteractionEventData()
+        eventData.SetWorldPosition([5, 5, 5])
+
+        distance = ref(0.0)
+        assert self.pipelineManager.CanProcessInteractionEvent(eventData, distance)
+        m1.mockCanProcess.assert_called_once()
+        m2.mockCanProcess.assert_not_called()
+        m3.mockCanProcess.assert_called_once()
+        assert self.pipelineManager.GetNumberOfPolledPipelines() == 2
+
+        # Moving the bounds refits the candidate selection
+        m2.SetWorldInteractionBounds([0, 10, 0, 10, 0, 10])
+        assert self.pipelineManager.CanProcessInteractionEvent(eventData, distance)
+        m2.mockCanProcess.assert_called_once()
+
+        # Events without world position are forwarded to all the pipelines
+        assert self.pipelineManager.CanProcessInteractionEvent(vtkMRMLInteractionEventData(), distance)
+        assert self.pipelineManager.GetNumberOfPolledPipelines() == 3
+
+    def test_focused_pipeline_is_polled_outside_of_its_bounds(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0, didProcess=True))
+        m1.SetDisplayInteractionBounds([0, 10, 0, 10])
+
+        eventData = vtkMRMLInteractionEventData()
+        eventData.SetDisplayPosition([5, 5])
+        distance = ref(0.0)
+        assert self.pipelineManager.CanProcessInteractionEvent(eventData, distance)
+        assert self.pipelineManager.ProcessInteractionEvent(eventData)
+
+        m1.mockCanProcess.reset_mock()
+        eventData.SetDisplayPosition([50, 50])
+        assert self.pipelineManager.CanProcessInteractionEvent(eventData, distance)
+        m1.mockCanProcess.assert_called_once()
+
+        # Once the focus is lost, the pipeline is filtered out again
+        self.pipelineManager.LoseFocus()
+        m1.mockCanProcess.reset_mock()
+        assert not self.pipelineManager.CanProcessInteractionEvent(eventData, distance)
+        m1.mockCanProcess.assert_not_called()
+
+    @staticmethod
+    def createEvent(eventType, x=0):
+        eventData = vtkMRMLInteractionEventData()
+        eventData.SetType(eventType)
+        eventData.SetDisplayPosition([x, 0])
+        return eventData
+
+    def dispatchEvent(self, eventData):
+        distance = ref(0.0)
+        return self.pipelineManager.CanProcessInteractionEvent(eventData, distance) and self.pipelineManager.ProcessInteractionEvent(eventData)
+
+    def test_mouse_moves_are_coalesced_until_the_pending_render(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0))
+        m1.mockProcess.side_effect = lambda _: self.pipelineManager.RequestRender() or True
+        self.pipelineManager.SetMouseMoveCoalescing(True)
+
+        # First move is processed and requests a render, the next ones are consumed without polling the pipelines
+        moves = [self.createEvent(vtkCommand.MouseMoveEvent, x) for x in range(4)]
+        for move in moves:
+            assert self.dispatchEvent(move)
+        m1.mockCanProcess.assert_called_once()
+        m1.mockProcess.assert_called_once_with(moves[0])
+        assert self.pipelineManager.GetNumberOfDroppedMouseMoves() == 2
+
+        # Latest move is forwarded when the render starts
+        self.renderWindow.InvokeEvent(vtkCommand.StartEvent)
+        assert m1.mockProcess.call_count == 2
+        assert m1.mockProcess.call_args[0][0] == moves[-1]
+
+        self.pipelineManager.ResetNumberOfDroppedMouseMoves()
+        assert self.pipelineManager.GetNumberOfDroppedMouseMoves() == 0
+
+    def test_coalesced_mouse_move_is_forwarded_before_button_events(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=0))
+        m1.mockProcess.side_effect = lambda _: self.pipelineManager.RequestRender() or True
+        self.pipelineManager.SetMouseMoveCoalescing(True)
+
+        assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, 0))
+        assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, 10))
+        assert self.dispatchEvent(self.createEvent(vtkCommand.LeftButtonReleaseEvent, 10))
+
+        eventTypes = [call[0][0].GetType() for call in m1.mockProcess.call_args_list]
+        assert eventTypes == [vtkCommand.MouseMoveEvent, vtkCommand.MouseMoveEvent, vtkCommand.LeftButtonReleaseEvent]
+        assert self.pipelineManager.GetNumberOfDroppedMouseMoves() == 0
+
+    def test_mouse_moves_are_not_coalesced_when_not_processed(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=False))
+        self.pipelineManager.SetMouseMoveCoalescing(True)
+        self.pipelineManager.RequestRender()
+
+        for x in range(3):
+            assert not self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, x))
+        assert m1.mockCanProcess.call_count == 3
+
+    def dispatchEventWithCompetitor(self, eventData, competitorDistance):
+        """
+        Emulate the view interactor style dispatching the event between the pipeline manager and a competing
+        displayable manager. The closest one processes the event and the other one loses the focus.
+        """
+        distance = ref(0.0)
+        if self.pipelineManager.CanProcessInteractionEvent(eventData, distance) and distance.get() < competitorDistance:
+            return self.pipelineManager.ProcessInteractionEvent(eventData)
+        self.pipelineManager.LoseFocus(eventData)
+        return False
+
+    def test_mouse_moves_won_by_a_competing_displayable_manager_are_not_coalesced(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=10))
+        m1.mockProcess.side_effect = lambda _: self.pipelineManager.RequestRender() or True
+        self.pipelineManager.SetMouseMoveCoalescing(True)
+
+        # First move is processed by the pipeline, the next ones are closer to the competing displayable manager
+        moves = [self.createEvent(vtkCommand.MouseMoveEvent, x) for x in range(3)]
+        assert self.dispatchEventWithCompetitor(moves[0], competitorDistance=100)
+        assert not self.dispatchEventWithCompetitor(moves[1], competitorDistance=1)
+
+        # The moves processed by the competing displayable manager never reach the pipeline
+        self.renderWindow.InvokeEvent(vtkCommand.StartEvent)
+        m1.mockProcess.assert_called_once_with(moves[0])
+
+        # Once the claim is lost, the moves are polled again
+        m1.mockCanProcess.reset_mock()
+        self.pipelineManager.RequestRender()
+        assert not self.dispatchEventWithCompetitor(moves[2], competitorDistance=1)
+        m1.mockCanProcess.assert_called_once()
+        self.renderWindow.InvokeEvent(vtkCommand.StartEvent)
+        m1.mockProcess.assert_called_once_with(moves[0])
+
+    def test_lost_coalescing_claim_stops_the_coalescing(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True, processDistance=10))
+        m1.mockProcess.side_effect = lambda _: self.pipelineManager.RequestRender() or True
+        self.pipelineManager.SetMouseMoveCoalescing(True)
+        assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, 0))
+
+        # Claim not followed by ProcessInteractionEvent (won by another displayable manager without focus change)
+        distance = ref(0.0)
+        assert self.pipelineManager.CanProcessInteractionEvent(self.createEvent(vtkCommand.MouseMoveEvent, 1), distance)
+        m1.mockCanProcess.reset_mock()
+        assert self.dispatchEvent(self.createEvent(vtkCommand.MouseMoveEvent, 2))
+        m1.mockCanProcess.assert_called_once()
+        assert m1.mockProcess.call_count == 2
+        assert self.pipelineManager.GetNumberOfDroppedMouseMoves() == 0
+
     def test_on_pipeline_added_triggers_modified_event(self):
         mock = MagicMock()
         self.pipelineManager.AddObserver(vtkCommand.ModifiedEvent, mock)
@@ -314,3 +553,121 @@ class PipelineManagerTest(ScriptedLoadableModuleTest):
         m1.mockLoseFocus.assert_not_called()
         self.pipelineManager.RemoveNode(m1.GetDisplayNode())
         m1.mockLoseFocus.assert_called_once()
+
+    def test_batch_processing_defers_pipeline_creation_until_end(self):
+        mock = MagicMock()
+        self.pipelineManager.AddObserver(vtkCommand.ModifiedEvent, mock)
+
+        self.pipelineManager.StartBatchProcess()
+        modelNodes = [vtkMRMLModelNode() for _ in range(5)]
+        for modelNode in modelNodes:
+            assert not self.pipelineManager.AddNode(modelNode)
+            assert self.pipelineManager.GetNodePipeline(modelNode) is None
+
+        assert self.pipelineManager.GetNumberOfPendingNodes() == 5
+        mock.assert_not_called()
+
+        self.pipelineManager.EndBatchProcess()
+        assert self.pipelineManager.GetNumberOfPendingNodes() == 0
+        mock.assert_called_once()
+        for modelNode in modelNodes:
+            pipeline = self.pipelineManager.GetNodePipeline(modelNode)
+            assert pipeline is not None
+            pipeline.mockOnRendererAdded.assert_called_once_with(self.defaultRenderer)
+            pipeline.mockUpdatePipeline.assert_called_once()
+
+    def test_nodes_removed_during_batch_processing_are_not_created(self):
+        self.pipelineManager.StartBatchProcess()
+        modelNode = vtkMRMLModelNode()
+        self.pipelineManager.AddNode(modelNode)
+        self.pipelineManager.RemoveNode(modelNode)
+        assert self.pipelineManager.GetNumberOfPendingNodes() == 0
+
+        self.mockModelCreate.reset_mock()
+        self.pipelineManager.EndBatchProcess()
+        self.mockModelCreate.assert_not_called()
+        assert self.pipelineManager.GetNodePipeline(modelNode) is None
+
+    def test_deferred_reset_display_is_coalesced_until_next_render(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline())
+        m1.SetDeferredResetDisplay(True)
+        m1.mockUpdatePipeline.reset_mock()
+        self.pipelineManager.ResetUpdateCounters()
+
+        for _ in range(5):
+            m1.ResetDisplay()
+
+        m1.mockUpdatePipeline.assert_not_called()
+        assert m1.IsDirty()
+        assert self.pipelineManager.GetNumberOfDirtyPipelines() == 1
+        assert self.pipelineManager.GetNumberOfCoalescedUpdates() == 4
+
+        # Dirty pipelines are updated when the render window starts rendering
+        self.renderWindow.InvokeEvent(vtkCommand.StartEvent)
+        m1.mockUpdatePipeline.assert_called_once()
+        assert not m1.IsDirty()
+        assert self.pipelineManager.GetNumberOfFlushedUpdates() == 1
+
+    def test_deferred_reset_display_can_be_flushed_synchronously(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline())
+        m2 = self.triggerMockPipelineCreation(MockPipeline())
+        for mock in [m1, m2]:
+            mock.SetDeferredResetDisplay(True)
+            mock.ResetDisplay()
+            mock.mockUpdatePipeline.reset_mock()
+
+        m1.ResetDisplayNow()
+        m1.mockUpdatePipeline.assert_called_once()
+        assert not m1.IsDirty()
+        assert m2.IsDirty()
+
+        self.pipelineManager.FlushDirtyPipelines()
+        m1.mockUpdatePipeline.assert_called_once()
+        m2.mockUpdatePipeline.assert_called_once()
+        assert self.pipelineManager.GetNumberOfDirtyPipelines() == 0
+
+    def test_performance_counters_measure_pipeline_dispatch_points(self):
+        m1 = self.triggerMockPipelineCreation(MockPipeline(canProcess=True))
+        assert m1.GetCallCount(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) == 0
+
+        self.pipelineManager.SetPerformanceCountersEnabled(True)
+        m1.ResetDisplay()
+        distance = ref(0.0)
+        self.pipelineManager.CanProcessInteractionEvent(vtkMRMLInteractionEventData(), distance)
+
+        assert m1.GetCallCount(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) == 1
+        assert m1.GetCallCount(vtkMRMLLayerDMPipelineI.CanProcessInteractionEventDispatch) == 1
+        assert m1.GetTotalTime(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) >= m1.GetMaxTime(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) > 0
+        assert "UpdatePipeline" in self.pipelineManager.GetPerformanceReport()
+
+        self.pipelineManager.ResetPerformanceCounters()
+        assert m1.GetCallCount(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) == 0
+
+        self.pipelineManager.SetPerformanceCountersEnabled(False)
+        m1.ResetDisplay()
+        assert m1.GetCallCount(vtkMRMLLayerDMPipelineI.UpdatePipelineDispatch) == 0
+
+    def test_tracer_exports_pipeline_events_in_chrome_trace_format(self):
+        tracer = vtkMRMLLayerDMTracer.GetInstance()
+        tracer.Clear()
+        tracer.SetEnabled(True)
+        try:
+            modelNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode")
+            m1 = self.pipelineManager.GetNodePipeline(modelNode)
+            assert m1 is not None
+            m1.ResetDisplay()
+        finally:
+            tracer.SetEnabled(False)
+
+        events = json.loads(tracer.GetChromeTrace())["traceEvents"]
+        creationEvents = [event for event in events if event["name"] == "CreatePipeline"]
+        assert len(creationEvents) == 1
+        assert creationEvents[0]["args"]["node"] == modelNode.GetID()
+        assert creationEvents[0]["args"]["pipeline"] == m1.GetClassName()
+        assert creationEvents[0]["args"]["view"] in (self.viewNode.GetLayoutName(), self.viewNode.GetID())
+        assert {"UpdateLayers", "RequestRender", "ResetCameraClippingRange"}.issubset({event["name"] for event in events})
+
+        # Disabled tracer doesn't record events
+        nEvents = tracer.GetNumberOfEvents()
+        m1.ResetDisplay()
+        assert tracer.GetNumberOfEvents() == nEvents